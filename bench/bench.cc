@@ -0,0 +1,125 @@
+// Time each phase of searchfvs for networks, and print the results as
+// tab-separated lines: label, build, network, phase, seconds.
+// Usage: bench [--label <label>] [--threads <number>] <network file>...
+// The outputs of the phases (e.g., the list of minimal FVSs) are discarded.
+
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <iostream>
+#include <limits>
+#include <streambuf>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "searchfvs.hh"
+
+using namespace std;
+
+// Discards everything written to it.
+class nullbuf : public streambuf {
+protected:
+  int overflow(int c){ return c; }
+  streamsize xsputn(const char*, streamsize n){ return n; }
+};
+
+int main(int argc, char** argv){
+  string label = "-";
+  int numthreads = 1;
+  vector<string> files;
+  for(auto k = 1; k < argc; ++k)
+    if(!strcmp(argv[k], "--label") && k+1 < argc)
+      label = argv[++k];
+    else if(!strcmp(argv[k], "--threads") && k+1 < argc)
+      numthreads = atoi(argv[++k]);
+    else
+      files.push_back(argv[k]);
+  if(files.empty()){
+    cerr << "Usage: " << argv[0] << " [--label <label>] [--threads <number>] <network file>..." << endl;
+    return 1;
+  }
+
+  nullbuf null;
+  auto out = cout.rdbuf();
+  const string build = withcbc ? "withcbc" : "withoutcbc";
+  for(const auto& f: files){
+    auto time = [&](const string& phase, const function<void()>& run){
+      cout.rdbuf(&null);
+      auto start = chrono::steady_clock::now();
+      run();
+      chrono::duration<double> t = chrono::steady_clock::now() - start;
+      cout.rdbuf(out);
+      cout << label << '\t' << build << '\t' << f << '\t' << phase << '\t' << t.count() << endl;
+    };
+
+    digraph dg;
+    dg.setnumthreads(numthreads);
+    int s = 0;
+    time("parse", [&]{ s = dg.read(f, vector<string>()); });
+    if(s)
+      return s;
+    time("cycles", [&]{ dg.detectcycles(); });
+    time("heuristic", [&]{ dg.estimateminnumFVS(); });
+    time("search", [&]{
+        if(withcbc)
+          dg.computeminnumFVS(false, true, false);
+        dg.dfs();
+      });
+    time("stats", [&]{ dg.calcstatFVS(); });
+    time("expand", [&]{ dg.expandFVSs(); });
+    time("output-list", [&]{ dg.outputFVSs(); });
+    time("output-polynomial", [&]{ dg.outputFVSsaspolynomial(); });
+    time("output-tree", [&]{ dg.outputFVSsastree(false, numeric_limits<int>::max()); });
+    time("output-stat", [&]{ dg.outputstat(); });
+    // the records of --format (nodes, minimal FVSs and statistics) through the buffer of searchfvs
+    for(const auto& f: {make_pair("tsv", outputformat::tsv), make_pair("jsonl", outputformat::jsonl),
+                        make_pair("binary", outputformat::binary)})
+      time(string("output-") + f.first, [&]{
+          outbuffer buffer(cout);
+          dg.setformat(f.second);
+          dg.outputnodes();
+          dg.outputFVSs();
+          dg.outputstat();
+          dg.setformat(outputformat::text);
+        });
+
+    // the other modes on fresh networks (parsing and cycle detection are not timed
+    // except the detection by induced paths)
+    {
+      digraph dg;
+      dg.setnumthreads(numthreads);
+      dg.setinducedcycles(true);
+      dg.read(f, vector<string>());
+      time("cycles-induced", [&]{ dg.detectcycles(); });
+    }
+    {
+      digraph dg;
+      dg.setnumthreads(numthreads);
+      dg.read(f, vector<string>());
+      time("reduce", [&]{ dg.reduce(); });
+      dg.detectcycles();
+      time("reduced-search", [&]{
+          dg.estimateminnumFVS();
+          if(withcbc)
+            dg.computeminnumFVS(false, true, false);
+          dg.dfs();
+          dg.calcstatFVS();
+        });
+    }
+    {
+      digraph dg;
+      dg.setnumthreads(numthreads);
+      dg.read(f, vector<string>());
+      dg.detectcycles();
+      time("count-only", [&]{
+          dg.estimateminnumFVS();
+          if(withcbc)
+            dg.computeminnumFVS(false, true, false);
+          dg.countFVSs();
+        });
+    }
+  }
+  return 0;
+}
@@ -0,0 +1,89 @@
+// Generate a random network for benchmarks in the format of searchfvs.
+// Usage: gengraph <model> <number of nodes> <edges per node> <seed>
+// Models:
+//  random:    edges are chosen uniformly at random.
+//  scalefree: nodes are added one by one with edges to and from the existing nodes,
+//             which are chosen with probability proportional to their degrees plus one.
+//  grn:       regulatory-style; a quarter of the nodes are transcription factors (TFs),
+//             which regulate genes chosen as scalefree, and some of the regulated genes are
+//             TFs, so that feedback loops among TFs are frequent.
+// The same arguments give the same network (the generator is std::mt19937_64).
+
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
+
+using namespace std;
+
+static mt19937_64 rng;
+
+inline static int randint(const int n){
+  return rng() % n;
+}
+
+int main(int argc, char** argv){
+  if(argc != 5){
+    cerr << "Usage: " << argv[0] << " <random|scalefree|grn> <number of nodes> <edges per node> <seed>" << endl;
+    return 1;
+  }
+  const string model = argv[1];
+  const int n = atoi(argv[2]);
+  const double d = atof(argv[3]);
+  rng.seed(strtoull(argv[4], nullptr, 10));
+  const long long m = n * d;
+  if(n < 2 || m < 1 || m > (long long)n * (n-1)){
+    cerr << "Error: illegal number of nodes or edges." << endl;
+    return 1;
+  }
+
+  set<pair<int, int>> edges;
+  auto add = [&](const int u, const int v){
+    return u != v && edges.emplace(u, v).second;
+  };
+  if(model == "random"){
+    while((long long)edges.size() < m)
+      add(randint(n), randint(n));
+  } else if(model == "scalefree"){
+    // endpoints: each node appears (degree + 1) times
+    vector<int> endpoints;
+    for(auto v = 0; v < n; ++v){
+      endpoints.push_back(v);
+      // about d edges for each node (fewer if there are not enough nodes yet)
+      for(auto tries = 0; v > 0 && (long long)edges.size() < (v+1) * d && tries < 4 * d; ++tries){
+        auto u = endpoints[randint(endpoints.size())];
+        if(randint(2) ? add(u, v) : add(v, u)){
+          endpoints.push_back(u);
+          endpoints.push_back(v);
+        }
+      }
+    }
+  } else if(model == "grn"){
+    const int numtfs = max(2, n / 4);
+    if(m > (long long)numtfs * (n-1)){
+      cerr << "Error: too many edges for the transcription factors." << endl;
+      return 1;
+    }
+    vector<int> regulators;     // each TF appears (number of targets + 1) times
+    for(auto t = 0; t < numtfs; ++t)
+      regulators.push_back(t);
+    while((long long)edges.size() < m){
+      // a TF is a target with probability 1/2, so that TFs regulate each other
+      auto v = randint(2) ? randint(numtfs) : randint(n);
+      auto u = regulators[randint(regulators.size())];
+      if(add(u, v))
+        regulators.push_back(u);
+    }
+  } else {
+    cerr << "Error: unknown model " << model << "." << endl;
+    return 1;
+  }
+
+  for(const auto& e: edges)
+    cout << 'N' << e.first << " N" << e.second << '\n';
+  return 0;
+}
@@ -0,0 +1,37 @@
+#!/bin/sh
+# Generate the benchmark networks (if not yet) and time the phases of searchfvs for them.
+# Usage: bench/run.sh <bench binary> [<label>]
+# The results (tab-separated: label, build, network, phase, seconds) are written to stdout.
+
+set -e
+BENCH=$1
+LABEL=${2:-$(git describe --always --dirty 2>/dev/null || echo -)}
+DIR=$(dirname "$0")
+DATA=$DIR/data
+
+# model, number of nodes, edges per node
+NETWORKS="
+random 50 2
+random 100 2
+random 150 2.5
+scalefree 100 2
+scalefree 200 2.5
+scalefree 300 2.2
+grn 100 3
+grn 200 4
+grn 300 3.5
+"
+
+mkdir -p "$DATA"
+FILES="$(dirname "$DIR")/ciona.txt"
+echo "$NETWORKS" | while read -r model n d; do
+  [ -n "$model" ] || continue
+  f=$DATA/${model}_n${n}_d${d}_s1.txt
+  [ -f "$f" ] || "$DIR/gengraph" "$model" "$n" "$d" 1 > "$f"
+done
+for f in "$DATA"/*_s1.txt; do
+  FILES="$FILES $f"
+done
+
+printf 'label\tbuild\tnetwork\tphase\tseconds\n'
+"$BENCH" --label "$LABEL" $FILES
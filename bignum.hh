@@ -0,0 +1,122 @@
+// bignum.hh, written by Kazuki Maeda <kmaeda at kmaeda.net>, 2020
+
+#ifndef _BIGNUM_HH_
+#define _BIGNUM_HH_
+
+#include <algorithm>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Nonnegative integer of arbitrary precision for counting FVSs,
+// whose numbers are products over SCCs and can exceed 64 bits.
+// Stored in base 2^32, least significant limb first, without leading zeros.
+class bignum {
+  std::vector<uint32_t> limbs;
+
+  inline void trim(){
+    while(!limbs.empty() && !limbs.back())
+      limbs.pop_back();
+  }
+
+public:
+  bignum(unsigned long long n = 0){
+    for(; n; n >>= 32)
+      limbs.push_back(uint32_t(n));
+  }
+
+  inline bool iszero() const {
+    return limbs.empty();
+  }
+
+  bignum& operator+=(const bignum& x){
+    if(limbs.size() < x.limbs.size())
+      limbs.resize(x.limbs.size());
+    uint64_t carry = 0;
+    for(unsigned int k = 0; k < limbs.size(); ++k){
+      carry += uint64_t(limbs[k]) + (k < x.limbs.size() ? x.limbs[k] : 0);
+      limbs[k] = uint32_t(carry);
+      carry >>= 32;
+      if(!carry && k >= x.limbs.size())
+        break;
+    }
+    if(carry)
+      limbs.push_back(uint32_t(carry));
+    return *this;
+  }
+
+  bignum operator*(const bignum& x) const {
+    bignum p;
+    if(iszero() || x.iszero())
+      return p;
+    p.limbs.assign(limbs.size() + x.limbs.size(), 0);
+    for(unsigned int i = 0; i < limbs.size(); ++i){
+      uint64_t carry = 0;
+      for(unsigned int j = 0; j < x.limbs.size(); ++j){
+        carry += uint64_t(limbs[i]) * x.limbs[j] + p.limbs[i+j];
+        p.limbs[i+j] = uint32_t(carry);
+        carry >>= 32;
+      }
+      p.limbs[i + x.limbs.size()] = uint32_t(carry);
+    }
+    p.trim();
+    return p;
+  }
+
+  inline bool operator<(const bignum& x) const {
+    if(limbs.size() != x.limbs.size())
+      return limbs.size() < x.limbs.size();
+    return std::lexicographical_compare(limbs.crbegin(), limbs.crend(),
+                                        x.limbs.crbegin(), x.limbs.crend());
+  }
+
+  // Decimal representation.
+  std::string str() const {
+    if(iszero())
+      return "0";
+    std::string s;
+    auto q = limbs;
+    while(!q.empty()){
+      // divide by 10^9 and append the remainder (9 digits, reversed)
+      uint64_t r = 0;
+      for(auto k = q.size(); k-- > 0; ){
+        r = (r << 32) | q[k];
+        q[k] = uint32_t(r / 1000000000);
+        r %= 1000000000;
+      }
+      while(!q.empty() && !q.back())
+        q.pop_back();
+      for(int d = 0; d < 9 && (r || !q.empty()); ++d, r /= 10)
+        s += char('0' + r % 10);
+    }
+    std::reverse(s.begin(), s.end());
+    return s;
+  }
+};
+
+// Sum of counts, accumulated in 64 bits while it fits and carried to a bignum
+// when it would overflow, so that adding small counts is as fast as with integers.
+class bigsum {
+  unsigned long long low;
+  bignum high;
+
+public:
+  bigsum() : low(0) {}
+
+  inline void add(const unsigned long long x){
+    if(__builtin_add_overflow(low, x, &low))
+      high += bignum(1ULL << 32) * bignum(1ULL << 32);
+  }
+
+  inline void add(const bignum& x){
+    high += x;
+  }
+
+  bignum value() const {
+    auto v = high;
+    v += low;
+    return v;
+  }
+};
+
+#endif
@@ -0,0 +1,136 @@
+// cycleset.hh, written by Kazuki Maeda <kmaeda at kmaeda.net>, 2020
+
+#ifndef _CYCLESET_HH_
+#define _CYCLESET_HH_
+
+#include <cstdint>
+#include <vector>
+#include "nodeset.hh"
+
+// Set of "local minimum" cycles with indices for subset and superset queries.
+//  - incidence[v] lists the cycles containing node v; a superset of c is searched
+//    in the list of the member of c appearing in the fewest cycles.
+//  - buckets[v] lists the cycles whose key node is v, where the key node is
+//    one member of the cycle; a subset of c has its key node in c.
+//  - A 64-bit signature (bit v%64 for each member v) filters candidates
+//    before they are compared as node sets.
+// Removed cycles are marked dead and are left in the lists until the set is compacted.
+template<int W>
+class cycleset {
+  std::vector<nodeset<W>> cycles;
+  std::vector<uint64_t> sigs;
+  std::vector<bool> alive;
+  std::vector<std::vector<int>> incidence;
+  std::vector<std::vector<int>> buckets;
+  int numalive;
+  unsigned long long numtried;  // calls of addandreduce
+
+  inline static uint64_t signature(const nodeset<W>& c){
+    uint64_t s = 0;
+    c.foreach([&](const int v){ s |= uint64_t(1) << (v & 63); });
+    return s;
+  }
+
+  void index(const int id){
+    int key = -1;
+    cycles[id].foreach([&](const int v){
+        incidence[v].push_back(id);
+        if(key < 0 || buckets[v].size() < buckets[key].size())
+          key = v;
+      });
+    buckets[key].push_back(id);
+  }
+
+  void compact(){
+    std::vector<nodeset<W>> live;
+    std::vector<uint64_t> livesigs;
+    for(unsigned int id = 0; id < cycles.size(); ++id)
+      if(alive[id]){
+        live.push_back(cycles[id]);
+        livesigs.push_back(sigs[id]);
+      }
+    cycles.swap(live);
+    sigs.swap(livesigs);
+    alive.assign(cycles.size(), true);
+    for(auto& l: incidence)
+      l.clear();
+    for(auto& l: buckets)
+      l.clear();
+    for(unsigned int id = 0; id < cycles.size(); ++id)
+      index(id);
+  }
+
+public:
+  explicit cycleset(const int numnodes)
+    : incidence(numnodes), buckets(numnodes), numalive(0), numtried(0) {}
+
+  inline int size() const {
+    return numalive;
+  }
+
+  // The number of cycles passed to addandreduce (added or not).
+  inline unsigned long long tried() const {
+    return numtried;
+  }
+
+  // Is there a cycle which is a subset of c (including c itself)?
+  bool hassubsetof(const nodeset<W>& c, const uint64_t sig) const {
+    bool found = false;
+    c.foreach([&](const int v){
+        if(found)
+          return;
+        for(const auto& id: buckets[v])
+          if(alive[id] && !(sigs[id] & ~sig) && cycles[id].issubsetof(c)){
+            found = true;
+            return;
+          }
+      });
+    return found;
+  }
+
+  void removesupersetsof(const nodeset<W>& c, const uint64_t sig){
+    int rarest = -1;
+    c.foreach([&](const int v){
+        if(rarest < 0 || incidence[v].size() < incidence[rarest].size())
+          rarest = v;
+      });
+    if(rarest < 0)
+      return;
+    for(const auto& id: incidence[rarest])
+      if(alive[id] && !(sig & ~sigs[id]) && c.issubsetof(cycles[id])){
+        alive[id] = false;
+        --numalive;
+      }
+    auto numdead = cycles.size() - numalive;
+    if(numdead > 1024 && numdead > (unsigned int)numalive)
+      compact();
+  }
+
+  // Add c unless a subset of c is already in the set,
+  // and remove the supersets of c (leave only local minimum cycles).
+  bool addandreduce(const nodeset<W>& c){
+    ++numtried;
+    auto sig = signature(c);
+    if(hassubsetof(c, sig))
+      return false;
+    removesupersetsof(c, sig);
+    cycles.push_back(c);
+    sigs.push_back(sig);
+    alive.push_back(true);
+    ++numalive;
+    index(cycles.size() - 1);
+    return true;
+  }
+
+  // Live cycles in the order of addition.
+  std::vector<nodeset<W>> extract() const {
+    std::vector<nodeset<W>> live;
+    live.reserve(numalive);
+    for(unsigned int id = 0; id < cycles.size(); ++id)
+      if(alive[id])
+        live.push_back(cycles[id]);
+    return live;
+  }
+};
+
+#endif
@@ -1,70 +1,297 @@
 // digraph.cc, written by Kazuki Maeda <kmaeda at kmaeda.net>, 2020
 
+#include <chrono>
 #include <iomanip>
+#include <cstring>
+#include <cctype>
+#include <cstdint>
+#include <cstdio>
 #include <fstream>
 #include <sstream>
-#include <cstring>
+#include <limits>
+#include <unordered_set>
+#include <set>
+#include <deque>
+#include <functional>
+#include <numeric>
 #include "digraph.hh"
+#include "nametable.hh"
+#include "mappedfile.hh"
 
 using namespace std;
 
 digraph::digraph(){
   numnodes = 0;
   numedges = 0;
-  minnumFVS = maxnumnodes;
+  minnumFVS = numeric_limits<unsigned int>::max();
+  numFVSs = 0;
+  reduced = false;
+  numkernelnodes = 0;
+  numkerneledges = 0;
+  packingbound = true;
+  lpbound = false;
+  compressclasses = false;
+  splitting = false;
+  inducedcycles = false;
+  profile = false;
+  progress = 0;
+  format = outputformat::text;
+  results = &cout;
+  messages = &cerr;
+  heuristicnumFVS = numeric_limits<unsigned int>::max();
+  heuristictime = 0;
 }
 
+// Split a token delimited by space characters.
+static inline bool nexttoken(const char*& p, const char* end, const char*& tok, size_t& len){
+  while(p != end && isspace((unsigned char)*p))
+    ++p;
+  tok = p;
+  while(p != end && !isspace((unsigned char)*p))
+    ++p;
+  len = p - tok;
+  return len;
+}
+
+// Binary network file written by convert (in the native byte order):
+//   "SFVSCSR1", the numbers of nodes n and edges m (uint32),
+//   offsets (n+1 uint32): the edges from node i go to targets[offsets[i]], ..., targets[offsets[i+1]-1],
+//   targets (m uint32),
+//   ranks (m uint32): the order in which the edges first appear in the text,
+//   nameoffsets (n+1 uint32): the name of node i is names[nameoffsets[i]], ..., names[nameoffsets[i+1]-1],
+//   names (the names of nodes concatenated).
+// The nodes and the edges are in the order of the text, so that the network is the same as
+// that read from the text. ranks are only used to remove nodes as readtext does.
+static const char graphmagic[8] = {'S', 'F', 'V', 'S', 'C', 'S', 'R', '1'};
+
 int digraph::read(const string filename, const vector<string>& removenodelist){
-  ifstream fin;
-  fin.exceptions(ios::failbit);
-  try{
-    fin.open(filename);
-  } catch (exception& e){
-    cerr << filename << ": " << strerror(errno) << endl;
+  mappedfile fin;
+  if(!fin.open(filename)){
+    *messages << filename << ": " << strerror(errno) << endl;
     return 1;
   }
+  auto s = fin.size() >= sizeof(graphmagic) && !memcmp(fin.data(), graphmagic, sizeof(graphmagic))
+    ? readbinary(fin, filename, removenodelist)
+    : readtext(fin, filename, removenodelist, nullptr);
+  if(!s)
+    decompose(edges);
+  return s;
+}
+
+// If ranks is not null, ranks[i][k] is set to the order of the edge edges[i][k] among the edges.
+int digraph::readtext(const mappedfile& fin, const string& filename,
+                      const vector<string>& removenodelist, vector<vector<uint32_t>>* ranks){
+  nametable nodetable(nodes);
+  nametable removetable(removenodelist);
+  vector<bool> removed(removenodelist.size());
+  unordered_set<uint64_t> edgeset;
 
   int lineno = 0;
-  while(!fin.eof()){
-    try{
-      string tmp;
-      getline(fin, tmp);
-      ++lineno;
-      if(tmp[0] != '#'){
-        string from, to, ill;
-        stringstream ss(tmp);
-        ss >> from >> to >> ill;
-        if(from == "" || to == "" || ill != ""){
-          cerr << filename << ":" << lineno << ": warning: illegal input line \"" << tmp << "\", ignored." << endl;
-          continue;
-        }
-        auto fromrem = find(removenodelist.cbegin(), removenodelist.cend(), from);
-        auto torem = find(removenodelist.cbegin(), removenodelist.cend(), to);
-        if(removenodelist.size() &&
-           (fromrem != removenodelist.cend() || torem != removenodelist.cend())){
-          if(fromrem != removenodelist.end() &&
-             find(removednodes.cbegin(), removednodes.cend(), from) == removednodes.cend())
-            removednodes.push_back(from);
-          if(torem != removenodelist.cend() &&
-             find(removednodes.cbegin(), removednodes.cend(), to) == removednodes.cend())
-            removednodes.push_back(to);
-          continue;
-        }
-        auto fromno = distance(nodes.cbegin(), find(nodes.cbegin(), nodes.cend(), from));
-        if(fromno == numnodes)
-          addnode(from);
-        auto tono = distance(nodes.cbegin(), find(nodes.cbegin(), nodes.cend(), to));
-        if(tono == numnodes)
-          addnode(to);
-        if(find(edges[fromno].cbegin(), edges[fromno].cend(), tono) == edges[fromno].cend()){
+  const char* p = fin.data();
+  const char* end = p + fin.size();
+  while(p != end){
+    const char* line = p;
+    const char* eol = static_cast<const char*>(memchr(p, '\n', end - p));
+    if(!eol)
+      eol = end;
+    p = eol == end ? end : eol + 1;
+    ++lineno;
+    if(line != eol && line[0] == '#')
+      continue;
+
+    const char *from, *to, *ill;
+    size_t fromlen, tolen, illlen;
+    const char* q = line;
+    nexttoken(q, eol, from, fromlen);
+    nexttoken(q, eol, to, tolen);
+    nexttoken(q, eol, ill, illlen);
+    if(!fromlen || !tolen || illlen){
+      *messages << filename << ":" << lineno << ": warning: illegal input line \"";
+      messages->write(line, eol - line);
+      *messages << "\", ignored." << endl;
+      continue;
+    }
+    if(removenodelist.size()){
+      auto fromrem = removetable.find(from, fromlen);
+      auto torem = removetable.find(to, tolen);
+      if(fromrem >= 0 || torem >= 0){
+        for(const auto& r: {fromrem, torem})
+          if(r >= 0 && !removed[r]){
+            removed[r] = true;
+            removednodes.push_back(removenodelist[r]);
+          }
+        continue;
+      }
+    }
+    auto fromno = nodetable.find(from, fromlen);
+    if(fromno < 0){
+      addnode(string(from, fromlen));
+      nodetable.insert(fromno = numnodes-1);
+    }
+    auto tono = nodetable.find(to, tolen);
+    if(tono < 0){
+      addnode(string(to, tolen));
+      nodetable.insert(tono = numnodes-1);
+    }
+    if(edgeset.insert((uint64_t)fromno << 32 | tono).second){
+      ++numedges;
+      edges[fromno].push_back(tono);
+      if(ranks){
+        ranks->resize(numnodes);
+        (*ranks)[fromno].push_back(numedges - 1);
+      }
+    }
+  }
+  return 0;
+}
+
+// The file is mapped by mmap, and the adjacency list of each node is copied from the arrays
+// at once (nothing is parsed; with removed nodes, the edges are filtered one by one).
+// Removed nodes are processed as in readtext: the nodes only in the edges with removed nodes
+// disappear, and the nodes are renumbered in the order of their first appearance in
+// the other edges (given by ranks; the source of an edge comes before the target).
+int digraph::readbinary(const mappedfile& fin, const string& filename,
+                        const vector<string>& removenodelist){
+  auto broken = [&]{
+    *messages << filename << ": broken binary network." << endl;
+    return 1;
+  };
+  auto w = reinterpret_cast<const uint32_t*>(fin.data() + sizeof(graphmagic));
+  auto numwords = (fin.size() - sizeof(graphmagic)) / sizeof(uint32_t);
+  if(numwords < 2)
+    return broken();
+  const uint32_t n = w[0], m = w[1];
+  if(numwords < 2 + 2 * ((size_t)n + 1) + 2 * (size_t)m)
+    return broken();
+  auto offsets = w + 2;
+  auto targets = offsets + n + 1;
+  auto ranks = targets + m;
+  auto nameoffsets = ranks + m;
+  auto names = reinterpret_cast<const char*>(nameoffsets + n + 1);
+  size_t nameslen = fin.data() + fin.size() - names;
+  if(offsets[0] || offsets[n] != m || nameoffsets[0] || nameoffsets[n] != nameslen)
+    return broken();
+  for(uint32_t i = 0; i < n; ++i)
+    if(offsets[i] > offsets[i+1] || nameoffsets[i] > nameoffsets[i+1])
+      return broken();
+  for(uint32_t e = 0; e < m; ++e)
+    if(targets[e] >= n)
+      return broken();
+  auto name = [&](const uint32_t i){
+    return string(names + nameoffsets[i], nameoffsets[i+1] - nameoffsets[i]);
+  };
+
+  if(removenodelist.empty()){
+    nodes.reserve(n);
+    edges.reserve(n);
+    for(uint32_t i = 0; i < n; ++i){
+      addnode(name(i));
+      edges[i].assign(targets + offsets[i], targets + offsets[i+1]);
+    }
+    numedges = m;
+    return 0;
+  }
+
+  vector<string> all(n);
+  for(uint32_t i = 0; i < n; ++i)
+    all[i] = name(i);
+  nametable table(all);
+  vector<int> removed(n, -1);   // index in removenodelist
+  for(int r = removenodelist.size() - 1; r >= 0; --r){
+    auto i = table.find(removenodelist[r]);
+    if(i >= 0)
+      removed[i] = r;
+  }
+  // first[i]: 2 * (rank of the first edge with i) + (1 if i is the target)
+  // among the edges without removed nodes (or with i if it is removed)
+  vector<uint64_t> first(n, numeric_limits<uint64_t>::max());
+  for(uint32_t u = 0; u < n; ++u)
+    for(auto e = offsets[u]; e < offsets[u+1]; ++e){
+      auto v = targets[e];
+      auto r = 2 * (uint64_t)ranks[e];
+      if(removed[u] < 0 && removed[v] < 0){
+        first[u] = min(first[u], r);
+        first[v] = min(first[v], r + 1);
+      } else {
+        if(removed[u] >= 0)
+          first[u] = min(first[u], r);
+        if(removed[v] >= 0)
+          first[v] = min(first[v], r + 1);
+      }
+    }
+  vector<uint32_t> order;
+  for(uint32_t i = 0; i < n; ++i)
+    if(first[i] != numeric_limits<uint64_t>::max())
+      order.push_back(i);
+  sort(order.begin(), order.end(), [&](const uint32_t i, const uint32_t j){ return first[i] < first[j]; });
+  vector<int> index(n, -1);
+  for(const auto& i: order)
+    if(removed[i] >= 0)
+      removednodes.push_back(removenodelist[removed[i]]);
+    else {
+      index[i] = numnodes;
+      addnode(all[i]);
+    }
+  for(uint32_t u = 0; u < n; ++u)
+    if(index[u] >= 0)
+      for(auto e = offsets[u]; e < offsets[u+1]; ++e)
+        if(index[targets[e]] >= 0){
+          edges[index[u]].push_back(index[targets[e]]);
           ++numedges;
-          edges[fromno].push_back(tono);
         }
-      }
-    } catch (exception& e) {
-      break;
+  return 0;
+}
+
+int digraph::convert(const string& textfile, const string& binfile){
+  mappedfile fin;
+  if(!fin.open(textfile)){
+    cerr << textfile << ": " << strerror(errno) << endl;
+    return 1;
+  }
+  if(fin.size() >= sizeof(graphmagic) && !memcmp(fin.data(), graphmagic, sizeof(graphmagic))){
+    cerr << textfile << ": already in the binary format." << endl;
+    return 1;
+  }
+  digraph dg;
+  vector<vector<uint32_t>> ranks;
+  auto s = dg.readtext(fin, textfile, vector<string>(), &ranks);
+  if(s)
+    return s;
+  ranks.resize(dg.numnodes);
+
+  auto tmp = binfile + ".tmp";
+  {
+    ofstream ofs(tmp, ios::binary);
+    auto put = [&](const void* x, const size_t len){
+      ofs.write(static_cast<const char*>(x), len);
+    };
+    vector<uint32_t> buf = {(uint32_t)dg.numnodes, (uint32_t)dg.numedges, 0};
+    for(const auto& e: dg.edges)
+      buf.push_back(buf.back() + e.size());
+    for(const auto& e: dg.edges)
+      buf.insert(buf.end(), e.cbegin(), e.cend());
+    for(const auto& r: ranks)
+      buf.insert(buf.end(), r.cbegin(), r.cend());
+    buf.push_back(0);
+    for(const auto& name: dg.nodes)
+      buf.push_back(buf.back() + name.length());
+    put(graphmagic, sizeof(graphmagic));
+    put(buf.data(), buf.size() * sizeof(uint32_t));
+    for(const auto& name: dg.nodes)
+      put(name.data(), name.length());
+    if(ofs.good())
+      ofs.close();
+    if(!ofs.good()){
+      cerr << "Error: cannot write " << tmp << "." << endl;
+      remove(tmp.c_str());
+      return 1;
     }
   }
+  if(rename(tmp.c_str(), binfile.c_str())){
+    cerr << "Error: cannot write " << binfile << "." << endl;
+    remove(tmp.c_str());
+    return 1;
+  }
   return 0;
 }
 
@@ -72,258 +299,1302 @@ void digraph::addnode(const string node){
   nodes.push_back(node);
   edges.emplace_back();
   ++numnodes;
-  if(numnodes > maxnumnodes){
-    cerr << "Error: the number of nodes in the input network is too large!" << endl;
-    cerr << "       Increase the value of maxnumnodes and recompile the program." << endl;
-    exit(1);
+}
+
+// Decompose the network g into strongly connected components (Tarjan's algorithm).
+void digraph::decompose(const vector<vector<int>>& g){
+  vector<int> index(numnodes, -1), lowlink(numnodes);
+  vector<bool> onstack(numnodes);
+  vector<int> stack;
+  vector<pair<int, unsigned int>> callstack; // (node, next edge to be searched)
+  vector<vector<int>> sccs;
+  int counter = 0;
+  for(int s = 0; s < numnodes; ++s){
+    if(index[s] >= 0)
+      continue;
+    index[s] = lowlink[s] = counter++;
+    stack.push_back(s);
+    onstack[s] = true;
+    callstack.emplace_back(s, 0);
+    while(!callstack.empty()){
+      auto v = callstack.back().first;
+      auto& e = callstack.back().second;
+      if(e < g[v].size()){
+        auto w = g[v][e++];
+        if(index[w] < 0){
+          index[w] = lowlink[w] = counter++;
+          stack.push_back(w);
+          onstack[w] = true;
+          callstack.emplace_back(w, 0);
+        } else if(onstack[w])
+          lowlink[v] = min(lowlink[v], index[w]);
+      } else {
+        callstack.pop_back();
+        if(!callstack.empty()){
+          auto u = callstack.back().first;
+          lowlink[u] = min(lowlink[u], lowlink[v]);
+        }
+        if(lowlink[v] == index[v]){
+          vector<int> scc;
+          int w;
+          do {
+            w = stack.back();
+            stack.pop_back();
+            onstack[w] = false;
+            scc.push_back(w);
+          } while(w != v);
+          sccs.push_back(scc);
+        }
+      }
+    }
+  }
+
+  // Only SCCs having a cycle (two or more nodes, or a self-loop) are needed.
+  vector<int> local(numnodes, -1);
+  components.clear();
+  for(auto& scc: sccs){
+    if(scc.size() == 1 &&
+       find(g[scc[0]].cbegin(), g[scc[0]].cend(), scc[0]) == g[scc[0]].cend())
+      continue;
+    sort(scc.begin(), scc.end());
+    for(unsigned int i = 0; i < scc.size(); ++i)
+      local[scc[i]] = i;
+    vector<vector<int>> sccedges(scc.size());
+    for(unsigned int i = 0; i < scc.size(); ++i)
+      for(const auto& v: g[scc[i]])
+        if(local[v] >= 0)
+          sccedges[i].push_back(local[v]);
+    for(const auto& v: scc)
+      local[v] = -1;
+    components.emplace_back();
+    components.back().nodes = scc;
+    components.back().solver = newfvssolver(scc.size(), sccedges);
+    components.back().minnumFVS = numeric_limits<unsigned int>::max();
+    components.back().upperbound = numeric_limits<unsigned int>::max();
+  }
+  sort(components.begin(), components.end(),
+       [](const component& x, const component& y)->bool{
+         return x.nodes[0] < y.nodes[0];
+       });
+}
+
+// Reduce the network by the rules of Levy and Low before detecting cycles:
+//  - a node with in-degree 0 or out-degree 0 is in no cycle, and is removed;
+//  - a node with a self-loop is in every FVS, and is removed as a forced node;
+//  - a node v with in-degree 1 (u -> v) or out-degree 1 (v -> u) is merged into u,
+//    since every cycle through v passes through u.
+// Minimal FVSs are searched in the reduced network (kernel). A minimal FVS of the network
+// is obtained by adding the forced nodes and replacing each node u with one of the nodes
+// merged into u (see _expandmerged).
+void digraph::reduce(){
+  vector<set<int>> in(numnodes), out(numnodes);
+  for(int i = 0; i < numnodes; ++i)
+    for(const auto& v: edges[i]){
+      out[i].insert(v);
+      in[v].insert(i);
+    }
+  vector<bool> alive(numnodes, true), queued(numnodes, true);
+  deque<int> queue;
+  for(int i = 0; i < numnodes; ++i)
+    queue.push_back(i);
+  merged.assign(numnodes, vector<int>());
+  forced.clear();
+
+  auto push = [&](const int v){
+    if(!queued[v]){
+      queued[v] = true;
+      queue.push_back(v);
+    }
+  };
+  auto removenode = [&](const int v){
+    alive[v] = false;
+    for(const auto& w: out[v])
+      if(w != v){
+        in[w].erase(v);
+        push(w);
+      }
+    for(const auto& u: in[v])
+      if(u != v){
+        out[u].erase(v);
+        push(u);
+      }
+    in[v].clear();
+    out[v].clear();
+  };
+  auto addedge = [&](const int u, const int w){
+    out[u].insert(w);
+    in[w].insert(u);
+    push(u);
+    push(w);
+  };
+
+  while(!queue.empty()){
+    auto v = queue.front();
+    queue.pop_front();
+    queued[v] = false;
+    if(!alive[v])
+      continue;
+    if(out[v].count(v)){
+      forced.push_back(v);
+      removenode(v);
+    } else if(in[v].empty() || out[v].empty())
+      removenode(v);
+    else if(in[v].size() == 1 || out[v].size() == 1){
+      int u;
+      if(in[v].size() == 1){
+        u = *in[v].begin();
+        auto succ = out[v];
+        removenode(v);
+        for(const auto& w: succ)
+          addedge(u, w);
+      } else {
+        u = *out[v].begin();
+        auto pred = in[v];
+        removenode(v);
+        for(const auto& w: pred)
+          addedge(w, u);
+      }
+      merged[u].push_back(v);
+      merged[u].insert(merged[u].end(), merged[v].cbegin(), merged[v].cend());
+      merged[v].clear();
+    }
+  }
+  sort(forced.begin(), forced.end());
+
+  vector<vector<int>> kernel(numnodes);
+  numkernelnodes = numkerneledges = 0;
+  for(int i = 0; i < numnodes; ++i)
+    if(alive[i]){
+      kernel[i].assign(out[i].cbegin(), out[i].cend());
+      ++numkernelnodes;
+      numkerneledges += kernel[i].size();
+    }
+  reduced = true;
+  decompose(kernel);
+}
+
+// Is the network acyclic after removing the nodes in removed?
+bool digraph::isacyclic(const vector<bool>& removed) const {
+  vector<int> indeg(numnodes), queue;
+  for(int i = 0; i < numnodes; ++i)
+    if(!removed[i])
+      for(const auto& v: edges[i])
+        ++indeg[v];
+  for(int i = 0; i < numnodes; ++i)
+    if(!removed[i] && !indeg[i])
+      queue.push_back(i);
+  int n = 0;
+  while(!queue.empty()){
+    auto v = queue.back();
+    queue.pop_back();
+    ++n;
+    for(const auto& w: edges[v])
+      if(!removed[w] && !--indeg[w])
+        queue.push_back(w);
   }
+  return n == numnodes - (int)count(removed.cbegin(), removed.cend(), true);
 }
 
-void digraph::addandreducecycles(const bitset<maxnumnodes>& cycle){
-  // add?
-  for(const auto& c: cycles)
-    if((cycle | c) == cycle)
+// Replace the nodes in the minimal FVS FVS (of the kernel with the forced nodes)
+// by the nodes merged into them in all possible ways, and call f for each FVS of the network
+// (one by one, since they may be too many to be stored).
+// Each node is fixed in order; a partial choice is abandoned if the network is
+// still cyclic without the chosen nodes and all the candidates of the rest.
+void digraph::_expandmerged(const vector<int>& FVS, const function<void(const vector<int>&)>& f) const {
+  vector<bool> removed(numnodes);
+  for(const auto& u: FVS){
+    removed[u] = true;
+    for(const auto& v: merged[u])
+      removed[v] = true;
+  }
+  vector<int> chosen;
+  function<void(unsigned int)> choose = [&](const unsigned int k){
+    if(k == FVS.size()){
+      f(chosen);
       return;
+    }
+    const auto u = FVS[k];
+    for(const auto& v: merged[u])
+      removed[v] = false;
+    for(unsigned int l = 0; l <= merged[u].size(); ++l){
+      const auto x = l ? merged[u][l-1] : u;
+      removed[u] = false;
+      removed[x] = true;
+      if(isacyclic(removed)){
+        chosen.push_back(x);
+        choose(k+1);
+        chosen.pop_back();
+      }
+      removed[x] = false;
+    }
+    removed[u] = true;
+    for(const auto& v: merged[u])
+      removed[v] = true;
+  };
+  choose(0);
+}
+
+void digraph::setnumthreads(const int numthreads){
+  if(numthreads > 1)
+    pool.reset(new threadpool(numthreads));
+  else
+    pool.reset();
+}
+
+void digraph::setlowerbounds(const bool packing, const bool lp){
+  packingbound = packing;
+  lpbound = lp;
+}
+
+void digraph::setsplitting(const bool split){
+  splitting = split;
+}
+
+void digraph::setformat(const outputformat format){
+  this->format = format;
+}
+
+void digraph::setprofile(const bool profile, const double progress){
+  this->profile = profile;
+  this->progress = progress;
+}
+
+void digraph::setoutput(ostream& results, ostream& messages){
+  this->results = &results;
+  this->messages = &messages;
+}
+
+void digraph::setinducedcycles(const bool induced){
+  inducedcycles = induced;
+}
 
-  // reduce (leave only local minimum cycles)
-  for(auto it = cycles.begin(); it != cycles.end(); ){
-    if((cycle | *it) == *it)
-      it = cycles.erase(it);
+void digraph::detectcycles(){
+  for(auto& c: components)
+    if(inducedcycles)
+      c.solver->detectinducedcycles(pool.get());
     else
-      ++it;
-  }
-  cycles.push_back(cycle);
-}
-
-void digraph::_detectcycles(const int start, const int i,
-                            const bitset<maxnumnodes>& searched,
-                            bitset<maxnumnodes>& path){
-  path.set(i);
-  bitset<maxnumnodes> nextsearched = searched;
-  for(const auto& v: edges[i])
-    nextsearched.set(v);        // prevent redundant search
-                                // E.g., if you have already found the path 0 -> 1,
-                                // then you can omit the path 0 -> 2 -> 1.
-  bool endflag = false;
-  bool cycleflag = false;
-  for(const auto& v: edges[i]){
-    if(v == start){
-      cycleflag = true;
-      break;
-    } else if(path[v]){
-      endflag = true; // If a branch returns to the node already passed,
-                      // all the results of further search will be redundant cycles.
-      break;
+      c.solver->detectcycles(pool.get());
+}
+
+// Cache file of chordless cycles (in the native byte order):
+//   "SFVSCYC1", fingerprint (uint64),
+//   for each SCC: the number of cycles (uint32), and for each cycle:
+//   the number of nodes (uint32) followed by the local indices (uint32).
+// The fingerprint is a hash of the network in which the cycles are detected,
+// i.e., the names of nodes, the edges, the removed nodes, and whether it is reduced.
+static const char cachemagic[8] = {'S', 'F', 'V', 'S', 'C', 'Y', 'C', '1'};
+
+static inline void fnv1a(uint64_t& h, const void* p, const size_t len){
+  auto s = static_cast<const unsigned char*>(p);
+  for(size_t k = 0; k < len; ++k){
+    h ^= s[k];
+    h *= 1099511628211ULL;
+  }
+}
+
+uint64_t digraph::fingerprint() const {
+  uint64_t h = 14695981039346656037ULL;
+  auto addint = [&](const uint32_t x){ fnv1a(h, &x, sizeof(x)); };
+  auto addstring = [&](const string& x){
+    addint(x.length());
+    fnv1a(h, x.data(), x.length());
+  };
+  addint(numnodes);
+  for(const auto& n: nodes)
+    addstring(n);
+  for(const auto& e: edges){
+    addint(e.size());
+    for(const auto& v: e)
+      addint(v);
+  }
+  addint(removednodes.size());
+  for(const auto& n: removednodes)
+    addstring(n);
+  addint(reduced);
+  return h;
+}
+
+// Returns false if the file does not exist or is not of this network.
+bool digraph::loadcycles(const string& filename){
+  mappedfile f;
+  if(!f.open(filename))
+    return false;
+  const char* p = f.data();
+  const char* end = p + f.size();
+  auto get = [&](void* x, const size_t len) -> bool {
+    if((size_t)(end - p) < len)
+      return false;
+    memcpy(x, p, len);
+    p += len;
+    return true;
+  };
+  char magic[8];
+  uint64_t fp;
+  if(!get(magic, sizeof(magic)) || memcmp(magic, cachemagic, sizeof(magic)) ||
+     !get(&fp, sizeof(fp)) || fp != fingerprint())
+    return false;
+
+  vector<vector<vector<int>>> cycles(components.size());
+  for(unsigned int k = 0; k < components.size(); ++k){
+    uint32_t n, len, v;
+    if(!get(&n, sizeof(n)) || n > f.size())
+      return false;
+    cycles[k].resize(n);
+    for(auto& c: cycles[k]){
+      if(!get(&len, sizeof(len)) || len > components[k].nodes.size())
+        return false;
+      c.resize(len);
+      for(auto& x: c){
+        if(!get(&v, sizeof(v)) || v >= components[k].nodes.size())
+          return false;
+        x = v;
+      }
     }
   }
+  if(p != end)
+    return false;
+  for(unsigned int k = 0; k < components.size(); ++k)
+    components[k].solver->setcycles(cycles[k]);
+  return true;
+}
 
-  if(cycleflag){
-    if(path.count())
-      addandreducecycles(path);
-  } else if(!endflag) {
-    for(const auto& v: edges[i]){
-      if(v < start || searched[v])
-        continue;
-      else
-        _detectcycles(start, v, nextsearched, path);
+// The file is written to a temporary file, which is renamed to filename,
+// so that other processes never read a partial file.
+void digraph::savecycles(const string& filename) const {
+  auto tmp = filename + ".tmp";
+  {
+    ofstream ofs(tmp, ios::binary);
+    auto put = [&](const void* x, const size_t len){
+      ofs.write(static_cast<const char*>(x), len);
+    };
+    put(cachemagic, sizeof(cachemagic));
+    uint64_t fp = fingerprint();
+    put(&fp, sizeof(fp));
+    vector<uint32_t> buf;
+    for(const auto& c: components){
+      uint32_t n = c.solver->numcycles();
+      put(&n, sizeof(n));
+      for(unsigned int i = 0; i < n; ++i){
+        auto cycle = c.solver->cycle(i);
+        buf.assign(1, cycle.size());
+        buf.insert(buf.end(), cycle.cbegin(), cycle.cend());
+        put(buf.data(), buf.size() * sizeof(uint32_t));
+      }
+    }
+    if(ofs.good())
+      ofs.close();
+    if(!ofs.good()){
+      *messages << "Warning: cannot write the cycle cache " << tmp << "." << endl;
+      remove(tmp.c_str());
+      return;
     }
   }
-  path.reset(i);
+  if(rename(tmp.c_str(), filename.c_str())){
+    *messages << "Warning: cannot write the cycle cache " << filename << "." << endl;
+    remove(tmp.c_str());
+  }
 }
 
-void digraph::detectcycles(){
-  bitset<maxnumnodes> path;
-  for(auto i = 0; i < numnodes; ++i){
-    bitset<maxnumnodes> searched;
-    searched.set(i);
-    _detectcycles(i, i, searched, path);
+// Seed the search with the sizes of the FVSs of SCCs found by the heuristic
+// (see fvssolverbase::heuristicFVS).
+void digraph::estimateminnumFVS(){
+  auto start = chrono::steady_clock::now();
+  heuristicnumFVS = forced.size();
+  for(auto& c: components){
+    c.upperbound = c.solver->heuristicFVS().size();
+    heuristicnumFVS += c.upperbound;
   }
-  sort(cycles.begin(), cycles.end(),
-       [](const bitset<maxnumnodes> &x, const bitset<maxnumnodes> &y)->bool{
-         return x.count() < y.count();
-       });
+  heuristictime = chrono::duration<double>(chrono::steady_clock::now() - start).count();
 }
 
-// Solve set cover problem by simple DFS.
-void digraph::_dfs(unsigned int cyclenum,
-                   bitset<maxnumnodes>& selected,
-                   bitset<maxnumnodes>& searched) {
-  bitset<maxnumnodes> nextsearched = searched;
-  while(cyclenum < cycles.size()){
-    if(!(selected & cycles[cyclenum]).count()){ // already covered?
-      if(selected.count() == minnumFVS)
-        return;
-      for(int i = 0; i < numnodes; ++i)
-        if(cycles[cyclenum][i] && !nextsearched[i]){
-          selected.set(i);
-          nextsearched.set(i);   // prevent duplicate listing
-          _dfs(cyclenum+1, selected, nextsearched);
-          selected.reset(i);
+void digraph::dfs(){
+  minnumFVS = forced.size();
+  for(auto& c: components){
+    c.solver->setlowerbounds(packingbound, lpbound);
+    c.solver->setsplitting(splitting);
+    c.solver->setprofile(profile, progress);
+    c.solver->setexpandclasses(!compressclasses);
+    c.minnumFVS = min(c.minnumFVS, c.upperbound);
+    c.solver->dfs(c.minnumFVS, c.FVSs, pool.get());
+    minnumFVS += c.minnumFVS;
+  }
+  if(compressclasses)
+    labelclasses();
+}
+
+// A class is shown as {A|B|C} in place of its representative.
+void digraph::labelclasses(){
+  labels = nodes;
+  nodeclasses.assign(numnodes, vector<int>());
+  for(const auto& c: components)
+    for(unsigned int i = 0; i < c.nodes.size(); ++i){
+      auto members = c.solver->classof(i);
+      if(members.size() > 1){
+        auto& l = labels[c.nodes[i]];
+        l = "{";
+        for(const auto& v: members){
+          nodeclasses[c.nodes[i]].push_back(c.nodes[v]);
+          if(l.length() > 1)
+            l += '|';
+          l += nodes[c.nodes[v]];
         }
-      return;
-    } else
-      ++cyclenum;
+        l += '}';
+      }
+    }
+}
+
+void digraph::setcompressclasses(const bool compress){
+  compressclasses = compress;
+}
+
+// A node (or a class of nodes) as a term of the polynomial.
+string digraph::polynomialterm(const int i) const {
+  if(!compressclasses || nodeclasses[i].empty())
+    return '"' + nodes[i] + '"';
+  // the sum of the members of the class
+  string t;
+  for(const auto& v: nodeclasses[i])
+    t += (t.empty() ? "(\"" : " + \"") + nodes[v] + '"';
+  return t + ')';
+}
+
+void digraph::minimize(){
+  minnumFVS = forced.size();
+  for(auto& c: components){
+    if(c.minnumFVS == numeric_limits<unsigned int>::max()){ // not computed by Cbc
+      c.solver->setlowerbounds(packingbound, lpbound);
+      c.solver->setsplitting(splitting);
+      c.solver->setprofile(profile, progress);
+      vector<int> FVS;
+      if(c.upperbound != numeric_limits<unsigned int>::max())
+        c.minnumFVS = c.upperbound + 1;
+      c.solver->minimize(c.minnumFVS, FVS, pool.get());
+    }
+    minnumFVS += c.minnumFVS;
   }
-  if(selected.count() < minnumFVS){
-    minnumFVS = selected.count();
-    FVSs.clear();
+}
+
+// Compute the minimum number of FVS and a minimal FVS without detecting all the cycles
+// (instead of detectcycles). For each SCC, the set cover problem is solved for the shortest
+// cycle through each node, and the shortest cycles in the SCC without the solution are
+// added until the solution is an FVS. The previous solution with a node of each uncovered
+// cycle is an upper bound for the next solve.
+void digraph::computeminnumFVSlazily(const bool nolist){
+  vector<int> FVS = forced;
+  minnumFVS = forced.size();
+  for(auto& c: components){
+    c.solver->setlowerbounds(packingbound, lpbound);
+    c.solver->setsplitting(splitting);
+    c.solver->setprofile(profile, progress);
+    vector<int> cFVS;
+    vector<bool> selected(c.nodes.size());
+    c.solver->addshortestcycles(cFVS);
+    do {
+      selected.assign(c.nodes.size(), false);
+      for(const auto& v: cFVS)
+        selected[v] = true;
+      unsigned int upper = cFVS.size();
+      for(unsigned int i = 0; i < c.solver->numcycles(); ++i){
+        auto cycle = c.solver->cycle(i);
+        if(none_of(cycle.cbegin(), cycle.cend(), [&](const int v){ return selected[v]; })){
+          selected[cycle[0]] = true;
+          ++upper;
+        }
+      }
+      c.minnumFVS = upper + 1;
+      c.solver->minimize(c.minnumFVS, cFVS, pool.get());
+    } while(c.solver->addshortestcycles(cFVS));
+    minnumFVS += c.minnumFVS;
+    for(const auto& v: cFVS)
+      FVS.push_back(c.nodes[v]);
+  }
+  if(reduced){
+    vector<int> first;
+    _expandmerged(FVS, [&](const vector<int>& x){
+        if(first.empty())
+          first = x;
+      });
+    FVS.swap(first);
+  }
+  sort(FVS.begin(), FVS.end());
+
+  outputheader();
+  if(nolist)
+    return;
+  if(format != outputformat::text){
+    recordwriter(*results, format).FVS(FVS.data(), FVS.size());
+    return;
+  }
+  unsigned int tmp = 1;
+  *results << "A minimal FVS: ";
+  for(const auto& i: FVS){
+    *results << nodes[i];
+    if(tmp < minnumFVS)
+      *results << ", ";
+    ++tmp;
+  }
+  *results << '\n';
+}
+
+// Screen knockouts: each line of filename is a set of nodes to be removed (names separated
+// by spaces). For each of them, the size and the number of minimal FVSs of the network
+// without the nodes are printed in a line. The cycles of each scenario are taken from those
+// of the network (see fvssolverbase::knockout), and the scenarios are solved in parallel
+// on the pool if any.
+int digraph::screenknockouts(const string& filename){
+  mappedfile fin;
+  if(!fin.open(filename)){
+    *messages << filename << ": " << strerror(errno) << endl;
+    return 1;
+  }
+  nametable nodetable(nodes);
+  vector<string> labels;
+  vector<vector<int>> scenarios;
+  int lineno = 0;
+  const char* p = fin.data();
+  const char* end = p + fin.size();
+  while(p != end){
+    const char* line = p;
+    const char* eol = static_cast<const char*>(memchr(p, '\n', end - p));
+    if(!eol)
+      eol = end;
+    p = eol == end ? end : eol + 1;
+    ++lineno;
+    if(line != eol && line[0] == '#')
+      continue;
+    string label;
+    vector<int> removed;
+    const char* tok;
+    size_t len;
+    const char* q = line;
+    while(nexttoken(q, eol, tok, len)){
+      if(!label.empty())
+        label += ' ';
+      label.append(tok, len);
+      auto v = nodetable.find(tok, len);
+      if(v >= 0)
+        removed.push_back(v);
+      else {
+        *messages << filename << ":" << lineno << ": warning: unknown node \"";
+        messages->write(tok, len);
+        *messages << "\", ignored." << endl;
+      }
+    }
+    labels.push_back(label.empty() ? "-" : label);
+    scenarios.push_back(removed);
   }
-  FVSs.push_back(selected);
+
+  vector<int> compof(numnodes, -1), localof(numnodes);
+  for(unsigned int k = 0; k < components.size(); ++k)
+    for(unsigned int i = 0; i < components[k].nodes.size(); ++i){
+      compof[components[k].nodes[i]] = k;
+      localof[components[k].nodes[i]] = i;
+    }
+  // The SCCs without knocked-out nodes are solved only once here
+  // (a solver must not be shared by the scenarios run in parallel).
+  // The minimal FVSs are only counted as they are found (after minimize), and the number
+  // of a scenario, the product over SCCs, is a bignum if it exceeds 64 bits.
+  minimize();
+  vector<unsigned int> baseminnums(components.size());
+  vector<unsigned long long> basenums(components.size());
+  for(unsigned int k = 0; k < components.size(); ++k){
+    auto& c = components[k];
+    baseminnums[k] = c.minnumFVS;
+    c.solver->dfs(c.minnumFVS, [&](const vector<int>&){ ++basenums[k]; }, pool.get());
+  }
+  vector<unsigned int> minnums(scenarios.size());
+  vector<bignum> nums(scenarios.size());
+  auto solve = [&](const unsigned int s){
+    vector<vector<int>> removed(components.size());
+    for(const auto& v: scenarios[s])
+      if(compof[v] >= 0)
+        removed[compof[v]].push_back(localof[v]);
+    minnums[s] = forced.size();
+    unsigned long long num = 1;
+    bool overflow = false;
+    for(unsigned int k = 0; k < components.size(); ++k){
+      unsigned long long n = 0;
+      if(removed[k].empty()){
+        minnums[s] += baseminnums[k];
+        n = basenums[k];
+      } else {
+        auto solver = components[k].solver->knockout(removed[k]);
+        unsigned int m = baseminnums[k] + 1; // removing nodes does not increase the size
+        vector<int> FVS;
+        solver->setlowerbounds(packingbound, lpbound);
+        solver->setsplitting(splitting);
+        solver->setprofile(profile, progress);
+        solver->minimize(m, FVS, nullptr);
+        solver->dfs(m, [&](const vector<int>&){ ++n; }, nullptr);
+        minnums[s] += m;
+      }
+      unsigned long long p;
+      if(overflow)
+        nums[s] = nums[s] * n;
+      else if(__builtin_mul_overflow(num, n, &p)){
+        overflow = true;
+        nums[s] = bignum(num) * n;
+      } else
+        num = p;
+    }
+    if(!overflow)
+      nums[s] = num;
+  };
+  if(pool){
+    for(unsigned int s = 0; s < scenarios.size(); ++s)
+      pool->submit([&, s](const int){ solve(s); });
+    pool->wait();
+  } else
+    for(unsigned int s = 0; s < scenarios.size(); ++s)
+      solve(s);
+
+  *results << "#knockout\t#[nodes of minimal FVS]\t#[minimal FVSs]\n";
+  for(unsigned int s = 0; s < scenarios.size(); ++s)
+    *results << labels[s] << '\t' << minnums[s] << '\t' << nums[s].str() << '\n';
+  return 0;
+}
+
+// Search minimal FVSs of the network (after minimize), and print each of them as soon as
+// it is found, in the order found and without the alignment of the numbers.
+void digraph::streamFVSs(const bool nolist, const bool printpolynomial){
+  recordwriter records(*results, format);
+  streamFVSs([&](const vector<int>& FVS){
+      if(nolist)
+        return;
+      if(format != outputformat::text){
+        records.FVS(FVS.data(), FVS.size());
+        return;
+      }
+      if(printpolynomial && numFVSs > 1)
+        *results << " + ";
+      else if(!printpolynomial)
+        *results << numFVSs << ": ";
+      bool first = true;
+      for(const auto& v: FVS){
+        if(!first)
+          *results << (printpolynomial ? " * " : ", ");
+        first = false;
+        if(printpolynomial)
+          *results << '"' << nodes[v] << '"';
+        else
+          *results << nodes[v];
+      }
+      *results << '\n';
+    });
+  if(!nolist && format == outputformat::text)
+    *results << '\n';
+}
+
+// The minimal FVSs of the SCC with the most nodes are not stored but combined
+// with the products of those of the other SCCs when found, so that the memory does not grow
+// with the number of minimal FVSs unless the other SCCs have many of them.
+// The statistics are accumulated on the way.
+void digraph::streamFVSs(const function<void(const vector<int>&)>& f){
+  int largest = -1;
+  for(unsigned int k = 0; k < components.size(); ++k){
+    auto& c = components[k];
+    if(largest < 0 || c.nodes.size() > components[largest].nodes.size())
+      largest = k;
+    c.solver->setlowerbounds(packingbound, lpbound);
+    c.solver->setsplitting(splitting);
+    c.solver->setprofile(profile, progress);
+  }
+  for(unsigned int k = 0; k < components.size(); ++k)
+    if((int)k != largest)
+      components[k].solver->dfs(components[k].minnumFVS, components[k].FVSs, pool.get());
+
+  numFVSs = 0;
+  statFVS.assign(numnodes, 0);
+  auto output = [&](const vector<int>& FVS){
+    for(const auto& v: FVS)
+      ++statFVS[v];
+    ++numFVSs;
+    f(FVS);
+  };
+  auto outputproducts = [&](const vector<int>& f){
+    foreachFVS([&](const vector<int>& others){
+        auto FVS = others;
+        for(const auto& v: f)
+          FVS.push_back(components[largest].nodes[v]);
+        if(reduced)
+          _expandmerged(FVS, [&](const vector<int>& x){
+              auto y = x;
+              sort(y.begin(), y.end());
+              output(y);
+            });
+        else {
+          sort(FVS.begin(), FVS.end());
+          output(FVS);
+        }
+      }, largest);
+  };
+  if(largest < 0)
+    outputproducts(vector<int>());
+  else
+    components[largest].solver->dfs(components[largest].minnumFVS, outputproducts, pool.get());
+  sortnodes();
+}
+
+// Count the minimal FVSs and the appearances of nodes in them without storing the FVSs.
+// The minimal FVSs of each SCC are passed one by one as FVSs of representatives of classes,
+// each of which stands for the products of the classes, and the counts of the network are
+// the products of those of SCCs. If the network has been reduced, the FVSs of the network
+// are expanded one by one by streamFVSs instead.
+// The counts are summed by bigsum, and the product of the classes is a bignum if it exceeds 64 bits.
+void digraph::countFVSs(){
+  minimize();
+  if(reduced){
+    bigsum n;
+    vector<bigsum> stat(numnodes);
+    streamFVSs([&](const vector<int>& f){
+        n.add(1);
+        for(const auto& v: f)
+          stat[v].add(1);
+      });
+    bignumFVSs = n.value();
+    bigstatFVS.resize(numnodes);
+    for(int i = 0; i < numnodes; ++i)
+      bigstatFVS[i] = stat[i].value();
+  } else {
+    vector<bignum> counts;
+    vector<vector<bignum>> stats;
+    for(auto& c: components){
+      c.solver->setlowerbounds(packingbound, lpbound);
+      c.solver->setsplitting(splitting);
+      c.solver->setprofile(profile, progress);
+      c.solver->setexpandclasses(false);
+      bigsum n;
+      vector<bigsum> stat(c.nodes.size());
+      vector<vector<int>> members(c.nodes.size()); // of the class represented by each node
+      vector<bignum> others;
+      c.solver->dfs(c.minnumFVS, [&](const vector<int>& f){
+          unsigned long long w = 1;
+          bool overflow = false;
+          for(const auto& v: f){
+            if(members[v].empty())
+              members[v] = compressclasses ? vector<int>(1, v) : c.solver->classof(v);
+            overflow = overflow || __builtin_mul_overflow(w, (unsigned long long)members[v].size(), &w);
+          }
+          if(!overflow){
+            n.add(w);
+            for(const auto& v: f)
+              for(const auto& u: members[v])
+                stat[u].add(w / members[v].size());
+            return;
+          }
+          // others[i]: the product of the sizes of the classes of f except f[i]
+          others.assign(f.size(), 1);
+          bignum p = 1;
+          for(unsigned int i = 0; i < f.size(); ++i){
+            others[i] = p;
+            p = p * members[f[i]].size();
+          }
+          n.add(p);
+          p = 1;
+          for(auto i = f.size(); i-- > 0; ){
+            others[i] = others[i] * p;
+            p = p * members[f[i]].size();
+          }
+          for(unsigned int i = 0; i < f.size(); ++i)
+            for(const auto& u: members[f[i]])
+              stat[u].add(others[i]);
+        }, pool.get());
+      counts.push_back(n.value());
+      stats.emplace_back();
+      for(const auto& x: stat)
+        stats.back().push_back(x.value());
+    }
+    if(compressclasses)
+      labelclasses();
+
+    // others[k]: the product of the counts of the SCCs except k
+    vector<bignum> others(components.size());
+    bignum p = 1;
+    for(unsigned int k = 0; k < components.size(); ++k){
+      others[k] = p;
+      p = p * counts[k];
+    }
+    bignumFVSs = p;
+    p = 1;
+    for(auto k = components.size(); k-- > 0; ){
+      others[k] = others[k] * p;
+      p = p * counts[k];
+    }
+    bigstatFVS.assign(numnodes, 0);
+    for(const auto& v: forced)
+      bigstatFVS[v] = bignumFVSs;
+    for(unsigned int k = 0; k < components.size(); ++k)
+      for(unsigned int i = 0; i < components[k].nodes.size(); ++i)
+        if(!stats[k][i].iszero())
+          bigstatFVS[components[k].nodes[i]] = others[k] * stats[k][i];
+  }
+  srtnodeind.resize(numnodes);
+  iota(srtnodeind.begin(), srtnodeind.end(), 0);
+  stable_sort(srtnodeind.begin(), srtnodeind.end(),
+              [&](const unsigned int i, const unsigned int j) {
+                return bigstatFVS[j] < bigstatFVS[i];
+              });
+}
+
+// The chordless cycles of the network sorted by their lengths and lexicographically.
+vector<vector<int>> digraph::sortedcycles() const {
+  vector<vector<int>> cycles;
+  for(const auto& c: components)
+    for(unsigned int i = 0; i < c.solver->numcycles(); ++i){
+      cycles.push_back(c.solver->cycle(i));
+      for(auto& v: cycles.back())
+        v = c.nodes[v];
+    }
+  sort(cycles.begin(), cycles.end(),
+       [](const vector<int>& x, const vector<int>& y)->bool{
+         return x.size() < y.size() || (x.size() == y.size() && x < y);
+       });
+  return cycles;
+}
+
+void digraph::foreachcycle(const function<void(const vector<int>&)>& f) const {
+  for(const auto& c: sortedcycles())
+    f(c);
 }
 
 void digraph::outputcycles(const bool nolist) const {
-  cout << "#[chordless cycles] = " << cycles.size() << endl;
+  const auto cycles = sortedcycles();
+  if(format != outputformat::text){
+    if(!nolist){
+      recordwriter records(*results, format);
+      for(const auto& c: cycles)
+        records.cycle(c);
+    }
+    return;
+  }
+  *results << "#[chordless cycles] = " << cycles.size() << '\n';
   if(!nolist){
     int n = 1;
     int w = to_string(cycles.size()).length();
     for(const auto& c: cycles){
       bool first = true;
-      cout << setw(w) << n << ": ";
-      for(int j = 0; j < numnodes; ++j)
-        if(c[j]){
-          if(!first)
-            cout << ", ";
-          else
-            first = false;
-          cout << nodes[j];
-        }
-      cout << endl;
+      *results << setw(w) << n << ": ";
+      for(const auto& j: c){
+        if(!first)
+          *results << ", ";
+        else
+          first = false;
+        *results << nodes[j];
+      }
+      *results << '\n';
       ++n;
     }
-    cout << endl;
+    *results << '\n';
   }
 }
 
+// Call f for each minimal FVS (with the forced nodes) of the kernel,
+// i.e., each element of the products of minimal FVSs of SCCs.
+// The SCC except (if any) is left out of the products.
+template<class F>
+void digraph::foreachFVS(F f, const int except) const {
+  vector<unsigned int> digits(components.size());
+  vector<int> FVS;
+  do {
+    FVS = forced;
+    for(unsigned int k = 0; k < components.size(); ++k)
+      if((int)k != except)
+        for(const auto& v: components[k].FVSs[digits[k]])
+          FVS.push_back(components[k].nodes[v]);
+    f(FVS);
+    unsigned int k = 0;
+    for(; k < components.size(); ++k){
+      if((int)k != except && ++digits[k] < components[k].FVSs.size())
+        break;
+      digits[k] = 0;
+    }
+    if(k == components.size())
+      break;
+  } while(true);
+}
 
-void digraph::calcstatFVS(){
-  _calcstatFVS(FVSs, statFVS);
-  for(int i = 0; i < maxnumnodes; ++i)
+// The FVSs of the kernel are expanded by the merged nodes if the network has been reduced.
+void digraph::foreachminimalFVS(const function<void(const vector<int>&)>& f) const {
+  // an FVS of classes (if compressclasses) stands for the products of the classes,
+  // which are expanded one by one
+  vector<int> x;
+  function<void(const vector<int>&, unsigned int)> expand = [&](const vector<int>& FVS, const unsigned int k){
+    if(k == FVS.size()){
+      auto y = x;
+      sort(y.begin(), y.end());
+      f(y);
+      return;
+    }
+    const auto u = FVS[k];
+    if(!compressclasses || nodeclasses[u].empty()){
+      x.push_back(u);
+      expand(FVS, k+1);
+      x.pop_back();
+      return;
+    }
+    for(const auto& v: nodeclasses[u]){
+      x.push_back(v);
+      expand(FVS, k+1);
+      x.pop_back();
+    }
+  };
+  foreachFVS([&](const vector<int>& FVS){
+      if(reduced)
+        _expandmerged(FVS, [&](const vector<int>& y){ expand(y, 0); });
+      else
+        expand(FVS, 0);
+    });
+}
+
+// The minimal FVSs of the network are the products of those of SCCs,
+// so that the statistics are computed without expanding them
+// unless the network has been reduced.
+// Return nonzero if the number of minimal FVSs exceeds 64 bits (they are counted by countFVSs).
+int digraph::calcstatFVS(){
+  if(!reduced){
+    numFVSs = 1;
+    for(const auto& c: components)
+      if(__builtin_mul_overflow(numFVSs, (unsigned long long)c.FVSs.size(), &numFVSs)){
+        *messages << "Error: too many minimal FVSs to be counted in 64 bits; use --count-only." << endl;
+        return 1;
+      }
+    statFVS.assign(numnodes, 0);
+    for(const auto& c: components){
+      auto others = numFVSs / c.FVSs.size();
+      for(const auto& f: c.FVSs)
+        for(const auto& v: f)
+          statFVS[c.nodes[v]] += others;
+    }
+  } else {
+    FVSs.clear();
+    numFVSs = 0;
+    foreachFVS([&](const vector<int>& f){
+        _expandmerged(f, [&](const vector<int>& x){
+            FVSs.insert(FVSs.end(), x.cbegin(), x.cend());
+            ++numFVSs;
+          });
+      });
+    statFVS.assign(numnodes, 0);
+    for(const auto& v: FVSs)
+      ++statFVS[v];
+  }
+  sortnodes();
+  return 0;
+}
+
+void digraph::sortnodes(){
+  srtnodeind.resize(numnodes);
+  for(int i = 0; i < numnodes; ++i)
     srtnodeind[i] = i;
+  stable_sort(srtnodeind.begin(), srtnodeind.end(),
+              [&](const unsigned int i, const unsigned int j) {
+                return statFVS[i] > statFVS[j];
+              });
+}
 
-  sort(srtnodeind, srtnodeind+maxnumnodes,
-       [&](const unsigned int i, const unsigned int j) {
-         return statFVS[i] > statFVS[j];
-       });
-  sort(FVSs.begin(), FVSs.end(),
-       [&](const bitset<maxnumnodes>& x, const bitset<maxnumnodes>& y) -> bool {
-         for(int i = 0; i < numnodes; ++i){
-           if(x[srtnodeind[i]] != y[srtnodeind[i]])
-             return x[srtnodeind[i]];
-         }
-         return true;
+// Expand the products of minimal FVSs of SCCs into FVSs (only needed for listing).
+// Return nonzero if they are too many to be stored.
+int digraph::expandFVSs(){
+  unsigned long long size;
+  if(__builtin_mul_overflow(numFVSs, (unsigned long long)minnumFVS, &size) || size > FVSs.max_size()){
+    *messages << "Error: too many minimal FVSs to be listed; use --no-list or --stream." << endl;
+    return 1;
+  }
+  vector<unsigned int> rank(numnodes);
+  for(int i = 0; i < numnodes; ++i)
+    rank[srtnodeind[i]] = i;
+
+  if(!reduced){
+    FVSs.clear();
+    FVSs.reserve(size);
+    foreachFVS([&](const vector<int>& f){ FVSs.insert(FVSs.end(), f.cbegin(), f.cend()); });
+  }
+  const auto m = minnumFVS;
+  for(unsigned long long i = 0; i < numFVSs; ++i)
+    sort(FVSs.begin() + i * m, FVSs.begin() + (i+1) * m,
+         [&](const int x, const int y) -> bool { return rank[x] < rank[y]; });
+  // sort FVSs by srtnodeind
+  vector<unsigned long long> order(numFVSs);
+  iota(order.begin(), order.end(), 0);
+  sort(order.begin(), order.end(),
+       [&](const unsigned long long x, const unsigned long long y) -> bool {
+         for(unsigned int i = 0; i < m; ++i)
+           if(FVSs[x * m + i] != FVSs[y * m + i])
+             return rank[FVSs[x * m + i]] < rank[FVSs[y * m + i]];
+         return false;
        });
+  vector<int> sorted;
+  sorted.reserve(FVSs.size());
+  for(const auto& i: order)
+    sorted.insert(sorted.end(), FVS(i), FVS(i) + m);
+  FVSs.swap(sorted);
+  return 0;
+}
+
+// The size of the FVS found by the heuristic (if estimateminnumFVS is called), printed by
+// outputprofile with --profile and by outputprunedbranches otherwise. The time is formatted
+// in a local stream, so that the flags of messages are not changed.
+void digraph::outputheuristic() const {
+  if(heuristicnumFVS == numeric_limits<unsigned int>::max())
+    return;
+  ostringstream t;
+  t << fixed << setprecision(3) << heuristictime;
+  *messages << "#[nodes of FVS found by heuristic] = " << heuristicnumFVS
+            << " (in " << t.str() << " s)" << endl;
+}
+
+// The heuristic and the pruned branches are printed by outputprofile with --profile.
+void digraph::outputprunedbranches() const {
+  if(profile)
+    return;
+  unsigned long long packing = 0, lp = 0;
+  for(const auto& c: components){
+    unsigned long long p, l;
+    c.solver->prunedbranches(p, l);
+    packing += p;
+    lp += l;
+  }
+  outputheuristic();
+  if(packingbound)
+    *messages << "#[branches pruned by packing bound] = " << packing << endl;
+  if(lpbound)
+    *messages << "#[branches pruned by LP bound] = " << lp << endl;
+}
+
+// The size of the FVS found by the heuristic and the counters of the solvers of SCCs
+// (those of knockout scenarios are not included).
+void digraph::outputprofile() const {
+  outputheuristic();
+  fvscounters total;
+  for(const auto& c: components){
+    auto n = c.solver->counters();
+    total.candidatecycles += n.candidatecycles;
+    total.rejectedcycles += n.rejectedcycles;
+    total.visited += n.visited;
+    total.prunedbypacking += n.prunedbypacking;
+    total.prunedbylp += n.prunedbylp;
+    total.discarded += n.discarded;
+  }
+  *messages << "#[cycles checked for minimality] = " << total.candidatecycles << endl;
+  *messages << "#[cycles rejected by minimality check] = " << total.rejectedcycles << endl;
+  *messages << "#[branches visited] = " << total.visited << endl;
+  if(packingbound)
+    *messages << "#[branches pruned by packing bound] = " << total.prunedbypacking << endl;
+  if(lpbound)
+    *messages << "#[branches pruned by LP bound] = " << total.prunedbylp << endl;
+  *messages << "#[FVSs discarded for smaller ones] = " << total.discarded << endl;
+}
+
+void digraph::outputheader() const {
+  if(format != outputformat::text){
+    recordwriter records(*results, format);
+    records.header(numnodes, numedges, minnumFVS);
+    if(reduced)
+      records.kernel(numkernelnodes, numkerneledges);
+    return;
+  }
+  *results << "#nodes,#edges,#[nodes of minimal FVS] = " << numnodes << "," << numedges << "," << minnumFVS << '\n';
+  if(reduced)
+    *results << "#[nodes of kernel],#[edges of kernel] = " << numkernelnodes << "," << numkerneledges << '\n';
+}
+
+// The beginning of the output in a machine-readable format: the names of the nodes
+// (to which the indices in the other records refer) and the removed nodes.
+void digraph::outputnodes() const {
+  recordwriter records(*results, format);
+  records.begin();
+  for(int i = 0; i < numnodes; ++i)
+    records.node(i, nodes[i]);
+  for(const auto& r: removednodes)
+    records.removed(r);
 }
 
 void digraph::outputremovednodes() const {
   if(!removednodes.empty()){
-    cout << "Removed nodes: ";
+    *results << "Removed nodes: ";
     bool first = true;
     for(const auto& r: removednodes){
       if(!first)
-        cout << ", ";
+        *results << ", ";
       else
         first = false;
-      cout << r;
+      *results << r;
     }
-    cout << endl << endl;
+    *results << "\n\n";
   }
 }
 
 void digraph::outputstat() const {
-  int ws = max_element(nodes.cbegin(), nodes.cend(),
-                      [](const string& x, const string& y)->bool{return x.length() < y.length();})->length();
-  int w = to_string(FVSs.size()).length();
-  cout << "Statistics:" << endl;
+  if(format != outputformat::text){
+    recordwriter records(*results, format);
+    for(int i = 0; i < numnodes && statFVS[srtnodeind[i]]; ++i)
+      records.stat(srtnodeind[i], to_string(statFVS[srtnodeind[i]]));
+    return;
+  }
+  int ws = 0;
+  for(int i = 0; i < numnodes; ++i)
+    ws = max<int>(ws, label(i).length());
+  int w = to_string(numFVSs).length();
+  *results << "Statistics:\n";
   for(int i = 0; i < numnodes; ++i)
     if(statFVS[srtnodeind[i]])
-      cout << setw(ws) << nodes[srtnodeind[i]] << ": " << setw(w) << statFVS[srtnodeind[i]] << endl;
+      *results << setw(ws) << label(srtnodeind[i]) << ": " << setw(w) << statFVS[srtnodeind[i]] << '\n';
     else
       break;
-  cout << endl;
+  *results << '\n';
+}
+
+void digraph::outputcounts(const bool printstat) const {
+  if(format != outputformat::text){
+    recordwriter records(*results, format);
+    records.count(bignumFVSs.str());
+    if(printstat)
+      for(int i = 0; i < numnodes && !bigstatFVS[srtnodeind[i]].iszero(); ++i)
+        records.stat(srtnodeind[i], bigstatFVS[srtnodeind[i]].str());
+    return;
+  }
+  *results << "#[minimal FVSs] = " << bignumFVSs.str() << '\n';
+  if(!printstat)
+    return;
+  int ws = 0;
+  for(int i = 0; i < numnodes; ++i)
+    ws = max<int>(ws, label(i).length());
+  int w = bignumFVSs.str().length();
+  *results << "\nStatistics:\n";
+  for(int i = 0; i < numnodes; ++i)
+    if(!bigstatFVS[srtnodeind[i]].iszero())
+      *results << setw(ws) << label(srtnodeind[i]) << ": " << setw(w) << bigstatFVS[srtnodeind[i]].str() << '\n';
+    else
+      break;
+  *results << '\n';
 }
 
 void digraph::outputFVSs() const {
-  int w = to_string(FVSs.size()).length();
-  for(unsigned int i = 0; i < FVSs.size(); ++i){
-    cout << setw(w) << i+1 << ": ";
-    unsigned int tmp = 1;
-    for(int j = 0; j < numnodes; ++j)
-      if(FVSs[i][srtnodeind[j]]){
-        cout << nodes[srtnodeind[j]];
-        if(tmp < minnumFVS)
-          cout << ", ";
-        ++tmp;
-      }
-    cout << endl;
+  if(format != outputformat::text){
+    recordwriter records(*results, format);
+    for(unsigned long long i = 0; i < numFVSs; ++i)
+      records.FVS(FVS(i), minnumFVS);
+    return;
   }
-  cout << endl;
+  int w = to_string(numFVSs).length();
+  for(unsigned long long i = 0; i < numFVSs; ++i){
+    *results << setw(w) << i+1 << ": ";
+    for(unsigned int k = 0; k < minnumFVS; ++k){
+      *results << label(FVS(i)[k]);
+      if(k+1 < minnumFVS)
+        *results << ", ";
+    }
+    *results << '\n';
+  }
+  *results << '\n';
 }
 
 void digraph::outputFVSsaspolynomial() const {
-  for(unsigned int i = 0; i < FVSs.size(); ++i){
-    unsigned int tmp = 1;
-    for(int j = 0; j < numnodes; ++j)
-      if(FVSs[i][srtnodeind[j]]){
-        cout << '"' << nodes[srtnodeind[j]] << '"';
-        if(tmp < minnumFVS)
-          cout << " * ";
-        ++tmp;
-      }
-    cout << endl;
-    if(i != FVSs.size()-1)
-      cout << " + ";
+  for(unsigned long long i = 0; i < numFVSs; ++i){
+    for(unsigned int k = 0; k < minnumFVS; ++k){
+      *results << polynomialterm(FVS(i)[k]);
+      if(k+1 < minnumFVS)
+        *results << " * ";
+    }
+    *results << '\n';
+    if(i != numFVSs-1)
+      *results << " + ";
   }
-  cout << endl;
+  *results << '\n';
 }
 
+// Print the minimal FVSs as a tree (or a factored polynomial). At each node of the tree,
+// the FVSs in the range [begin, end) of order are partitioned in place into those containing
+// the node appearing most in the range (target) and the others, which are the children
+// and the following siblings respectively.
+// stats[level] is the numbers of appearances of nodes in the range except the targets of
+// the ancestors (inpath). Only the smaller part is counted, and the counts of the other part
+// are obtained by subtraction.
+void digraph::outputFVSsastree(const bool printpolynomial, const int maxtreedepth) const {
+  if(!minnumFVS)
+    return;
+  vector<unsigned long long> order(numFVSs);
+  iota(order.begin(), order.end(), 0);
+  vector<vector<unsigned long long>> stats(minnumFVS);
+  stats[0] = statFVS;
+  vector<bool> inpath(numnodes);
+  int prevlevel = -1;
+  _outputFVSsastree(order, 0, numFVSs, stats, inpath, 0, printpolynomial, maxtreedepth, prevlevel);
+}
 
-void digraph::_outputFVSsastree(const vector<bitset<maxnumnodes>>& currentFVSs,
-                                const int* statFVS,
-                                const int pnum,
+void digraph::_outputFVSsastree(vector<unsigned long long>& order,
+                                unsigned long long begin,
+                                const unsigned long long end,
+                                vector<vector<unsigned long long>>& stats,
+                                vector<bool>& inpath,
                                 const int level,
                                 const bool printpolynomial,
-                                const int maxtreedepth) const {
-  static int prevlevel = -1;
-  if(!currentFVSs.size())
-    return;
+                                const int maxtreedepth,
+                                int& prevlevel) const {
+  const auto pnum = end - begin;
+  auto& stat = stats[level];
+  // count nodes (except those in the path) of the FVSs in [b, e) to count
+  auto countnodes = [&](const unsigned long long b, const unsigned long long e,
+                        vector<unsigned long long>& count){
+    count.assign(numnodes, 0);
+    for(auto i = b; i < e; ++i)
+      for(unsigned int k = 0; k < minnumFVS; ++k)
+        if(!inpath[FVS(order[i])[k]])
+          ++count[FVS(order[i])[k]];
+  };
+  vector<unsigned long long> count;
+  // the following siblings are in the loop
+  while(begin < end){
+    int targetnode = max_element(stat.cbegin(), stat.cend()) - stat.cbegin();
+    auto mid = partition(order.begin() + begin, order.begin() + end,
+                         [&](const unsigned long long i) -> bool {
+                           return find(FVS(i), FVS(i) + minnumFVS, targetnode) != FVS(i) + minnumFVS;
+                         }) - order.begin();
+    bool haschildren = level+1 < (int)minnumFVS; // the FVSs are not empty without targetnode
 
-  int targetnode = max_element(statFVS, statFVS+maxnumnodes)-statFVS;
-  vector<bitset<maxnumnodes>> hFVSs;
-  vector<bitset<maxnumnodes>> nFVSs;
-  for(const auto& c: currentFVSs){
-    if(c[targetnode]){
-      bitset<maxnumnodes> tmp = c;
-      tmp.reset(targetnode);
-      if(tmp.any())
-        hFVSs.push_back(tmp);
-    } else
-      nFVSs.push_back(c);
-  }
-
-  if(printpolynomial){
-    int difflevel = prevlevel - level;
-    if(difflevel >= 0)
-      cout << " + ";
-    cout << "\"" << nodes[targetnode] << "\"";
-    if(hFVSs.size() != 0)
-      cout << " * (";
-    prevlevel = level;
-  } else {
-    for(int i = 0; i < level; ++i)
-      cout << string("|   ");
-    cout << level+1 << ": " << nodes[targetnode] << " (" << statFVS[targetnode] << "/" << pnum << ")" << endl;
-  }
-
-  int stathFVSs[maxnumnodes];
-  int statnFVSs[maxnumnodes];
-  if(hFVSs.size())
-    _calcstatFVS(hFVSs, stathFVSs);
-  if(nFVSs.size())
-    _calcstatFVS(nFVSs, statnFVSs);
-
-  if(printpolynomial || level+1 < maxtreedepth)
-    _outputFVSsastree(hFVSs, stathFVSs, hFVSs.size(), level+1, printpolynomial, maxtreedepth);
-  if(printpolynomial && hFVSs.size() != 0)
-    cout << ")";
-  _outputFVSsastree(nFVSs, statnFVSs, pnum, level, printpolynomial, maxtreedepth);
+    if(printpolynomial){
+      int difflevel = prevlevel - level;
+      if(difflevel >= 0)
+        *results << " + ";
+      *results << polynomialterm(targetnode);
+      if(haschildren)
+        *results << " * (";
+      prevlevel = level;
+    } else {
+      for(int i = 0; i < level; ++i)
+        *results << string("|   ");
+      *results << level+1 << ": " << label(targetnode) << " (" << stat[targetnode] << "/" << pnum << ")\n";
+    }
+
+    // stats of the children (if printed) and the following siblings
+    bool printchildren = haschildren && (printpolynomial || level+1 < maxtreedepth);
+    if(mid - begin <= end - mid){
+      countnodes(begin, mid, count);
+      for(int v = 0; v < numnodes; ++v)
+        stat[v] -= count[v];
+      if(printchildren){
+        count[targetnode] = 0;
+        stats[level+1].swap(count);
+      }
+    } else {
+      countnodes(mid, end, count);
+      if(printchildren){
+        auto& child = stats[level+1];
+        child.resize(numnodes);
+        for(int v = 0; v < numnodes; ++v)
+          child[v] = stat[v] - count[v];
+        child[targetnode] = 0;
+      }
+      stat.swap(count);
+    }
+
+    if(printchildren){
+      inpath[targetnode] = true;
+      _outputFVSsastree(order, begin, mid, stats, inpath, level+1, printpolynomial, maxtreedepth, prevlevel);
+      inpath[targetnode] = false;
+    }
+    if(printpolynomial && haschildren)
+      *results << ")";
+    begin = mid;
+  }
 }
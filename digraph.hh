@@ -3,82 +3,171 @@
 #ifndef _DIGRAPH_HH_
 #define _DIGRAPH_HH_
 
+#include <cstdint>
+#include <functional>
 #include <iostream>
 #include <vector>
 #include <string>
-#include <bitset>
+#include <memory>
 #include <algorithm>
 
-class digraph {
-public:
-  const static int maxnumnodes = 10000; // The max number of nodes of input network.
-                                // If the input network has more nodes, increase this value
-                                // and recompile.
-                                // Developer notes: we can use boost::dynamic_bitset
-                                // as an alternative of std::bitset. However, dynamic_bitset
-                                // is much slower than bitset.
+#include "bignum.hh"
+#include "fvssolver.hh"
+#include "threadpool.hh"
+#include "writer.hh"
 
+class mappedfile;
+
+class digraph {
 private:
+  // A nontrivial strongly connected component (SCC) of the network.
+  // Every cycle lies in an SCC, so that a minimal FVS of the network is
+  // the union of minimal FVSs of the SCCs.
+  struct component {
+    std::vector<int> nodes;            // nodes of the SCC in ascending order (local index -> node)
+    std::unique_ptr<fvssolverbase> solver;
+    unsigned int minnumFVS;
+    unsigned int upperbound;           // the size of the FVS found by estimateminnumFVS
+    std::vector<std::vector<int>> FVSs; // minimal FVSs of the SCC (local indices)
+  };
+
   int numnodes, numedges;
   unsigned int minnumFVS;
+  unsigned long long numFVSs;          // the product of the numbers of minimal FVSs of SCCs
   std::vector<std::string> nodes;
   std::vector<std::vector<int>> edges; // edges[i] = {j0, j1, j2, ...}: i -> j
-  unsigned int srtnodeind[maxnumnodes]; // node index sorted by the number appearing in the minimal FVSs
-  int statFVS[maxnumnodes];
-  std::vector<std::bitset<maxnumnodes>> cycles; // cycles[i][j]: if node j is in cycle i
-                                                // Note: this is the set of "local minimum" cycles (chordless cycles).
-                                                // E.g., if there are cycles {1101} and {1001},
-                                                // only {1001} is included in the cycles variable.
+  std::vector<unsigned int> srtnodeind; // node index sorted by the number appearing in the minimal FVSs
+  std::vector<unsigned long long> statFVS;
+  bignum bignumFVSs;                   // numFVSs and statFVS computed by countFVSs
+  std::vector<bignum> bigstatFVS;
+  std::vector<component> components;   // decomposed when the network has been read (or reduced)
+  bool reduced;                        // see reduce()
+  int numkernelnodes, numkerneledges;
+  std::vector<int> forced;             // nodes in every minimal FVS (removed from the kernel)
+  std::vector<std::vector<int>> merged; // merged[u]: nodes merged into u
   std::vector<std::string> removednodes;   // actually removed nodes
-  std::vector<std::bitset<maxnumnodes>> FVSs;
+  std::vector<int> FVSs;                   // expanded by expandFVSs: numFVSs FVSs of minnumFVS nodes each,
+                                           // flattened; each FVS is a list of nodes sorted by srtnodeind
+  std::unique_ptr<threadpool> pool;        // null if single-threaded
+  bool packingbound, lpbound;              // lower bounds used in dfs
+  bool splitting;                          // search by splitting cycles into independent groups
+  bool inducedcycles;                      // detect cycles by fvssolverbase::detectinducedcycles
+  bool profile;                            // count the branches visited by the search
+  double progress;                         // interval of progress lines of the search (0: none)
+  outputformat format;                     // of the outputs except the tree and the polynomial
+  std::ostream* results;                   // the outputs (std::cout by default)
+  std::ostream* messages;                  // warnings and diagnostics (std::cerr by default)
+  bool compressclasses;                    // FVSs consist of classes of nodes (see setcompressclasses)
+  std::vector<std::string> labels;         // names of nodes or classes in the output if compressclasses
+  std::vector<std::vector<int>> nodeclasses; // nodeclasses[i]: nodes in the class represented by i (if two or more)
+  unsigned int heuristicnumFVS;            // the size of the FVS found by estimateminnumFVS
+  double heuristictime;                    // in seconds
+
+  inline const std::string& label(const int i) const {
+    return labels.empty() ? nodes[i] : labels[i];
+  }
+  std::string polynomialterm(const int i) const;
 
-  inline static void _calcstatFVS(const std::vector<std::bitset<maxnumnodes>> listFVSs,
-                                  int* statFVS) {
-    for(auto i = 0; i < maxnumnodes; ++i)
-      statFVS[i] = count_if(listFVSs.cbegin(), listFVSs.cend(),
-                            [&](const std::bitset<maxnumnodes>& b)->bool{return b[i];});
+  inline const int* FVS(const unsigned long long i) const {
+    return FVSs.data() + i * minnumFVS;
   }
 
   void addnode(const std::string node);
-  void addandreducecycles(const std::bitset<maxnumnodes>& cycle);
-  void _detectcycles(const int start, const int i,
-                     const std::bitset<maxnumnodes>& searched,
-                     std::bitset<maxnumnodes>& path);
-  void _dfs(unsigned int cyclenum,
-            std::bitset<maxnumnodes>& selected,
-            std::bitset<maxnumnodes>& searched);
-  void _outputFVSsastree(const std::vector<std::bitset<maxnumnodes>>& currentFVSs,
-                         const int* statFVS,
-                         const int pnum,
+  int readtext(const mappedfile& fin, const std::string& filename,
+               const std::vector<std::string>& removenodelist,
+               std::vector<std::vector<uint32_t>>* ranks);
+  int readbinary(const mappedfile& fin, const std::string& filename,
+                 const std::vector<std::string>& removenodelist);
+  void decompose(const std::vector<std::vector<int>>& g);
+  std::vector<std::vector<int>> sortedcycles() const;
+  bool isacyclic(const std::vector<bool>& removed) const;
+  template<class F> void foreachFVS(F f, const int except = -1) const;
+  void sortnodes();
+  void labelclasses();
+  uint64_t fingerprint() const;
+  void _expandmerged(const std::vector<int>& FVS, const std::function<void(const std::vector<int>&)>& f) const;
+  void _outputFVSsastree(std::vector<unsigned long long>& order,
+                         unsigned long long begin,
+                         const unsigned long long end,
+                         std::vector<std::vector<unsigned long long>>& stats,
+                         std::vector<bool>& inpath,
                          const int level,
                          const bool printpolynomial,
-                         const int maxtreedepth) const;
+                         const int maxtreedepth,
+                         int& prevlevel) const;
 
 public:
   digraph();
+  // Read the network from a text file of edges, or from a binary file written by convert.
   int read(const std::string filename, const std::vector<std::string>& removenodelist);
+  // Write the network in the text file textfile to binfile in the binary format (see readbinary).
+  static int convert(const std::string& textfile, const std::string& binfile);
+  void reduce();
+  void setnumthreads(const int numthreads);
+  void setlowerbounds(const bool packing, const bool lp);
+  // Search by splitting the cycles into independent groups with memoization (single-threaded).
+  void setsplitting(const bool split);
+  // Count the work of the search (see outputprofile), and print a progress line to stderr
+  // every progress seconds during the search of each SCC if progress > 0.
+  void setprofile(const bool profile, const double progress);
+  // List minimal FVSs up to nodes in the same cycles: such nodes are grouped into a class
+  // shown as {A|B|C}, and the FVSs, the statistics and the tree are of classes.
+  void setcompressclasses(const bool compress);
+  // Print the results as records of a machine-readable format (see recordwriter) instead of text.
+  // The tree, the polynomial and the classes are only in text.
+  void setformat(const outputformat format);
+  // Detect chordless cycles by the search removing non-chordless cycles (default), or by
+  // extending induced paths if induced (the same cycles; faster on dense networks).
+  void setinducedcycles(const bool induced);
+  // Print the outputs to results and the warnings and diagnostics (e.g., outputprunedbranches)
+  // to messages instead of std::cout and std::cerr. The progress lines of the search are
+  // always printed to std::cerr.
+  void setoutput(std::ostream& results, std::ostream& messages);
   void detectcycles();
-  void calcstatFVS();
+  bool loadcycles(const std::string& filename);
+  void savecycles(const std::string& filename) const;
+  // Find an FVS of each SCC by a heuristic, whose size bounds the search.
+  void estimateminnumFVS();
+  void dfs();
+  int calcstatFVS();
+  void minimize();
+  void computeminnumFVSlazily(const bool nolist);
+  void streamFVSs(const bool nolist, const bool printpolynomial);
+  // Search minimal FVSs (after minimize) and call f for each of them as soon as it is found.
+  void streamFVSs(const std::function<void(const std::vector<int>&)>& f);
+  // Only count the minimal FVSs and the appearances of nodes (in arbitrary precision).
+  void countFVSs();
+  int screenknockouts(const std::string& filename);
+  int expandFVSs();
+
+  // Results for the callers of the library, where nodes are given by their indices.
+  inline int getnumnodes() const { return numnodes; }
+  inline const std::string& nodename(const int i) const { return nodes[i]; }
+  inline unsigned int getminnumFVS() const { return minnumFVS; }
+  inline unsigned long long getnumFVSs() const { return numFVSs; }        // after calcstatFVS or streamFVSs
+  inline unsigned long long getstatFVS(const int i) const { return statFVS[i]; }
+  // Call f for each chordless cycle (after detectcycles) in the order of outputcycles.
+  void foreachcycle(const std::function<void(const std::vector<int>&)>& f) const;
+  // Call f for each minimal FVS (after dfs) as the sorted list of its nodes, without expanding
+  // them all: the classes of setcompressclasses are also expanded one FVS at a time.
+  void foreachminimalFVS(const std::function<void(const std::vector<int>&)>& f) const;
+
   void outputcycles(const bool nolist) const;
   void outputremovednodes() const;
+  void outputnodes() const;           // node records (if not text)
   void outputstat() const;
+  void outputcounts(const bool printstat) const;
   void outputFVSs() const;
   void outputFVSsaspolynomial() const;
+  void outputheuristic() const;
+  void outputprunedbranches() const;
+  void outputprofile() const;
 
-  inline void dfs(){
-    std::bitset<maxnumnodes> selected, searched;
-    _dfs(0, selected, searched);
-  }
-
-  inline void outputheader() const {
-    std::cout << "#nodes,#edges,#[nodes of minimal FVS] = " << numnodes << "," << numedges << "," << minnumFVS << std::endl;
-  }
+  void outputheader() const;
 
-  inline void outputFVSsastree(const bool printpolynomial, const int maxtreedepth) const {
-    _outputFVSsastree(FVSs, statFVS, FVSs.size(), 0, printpolynomial, maxtreedepth);
-  }
+  void outputFVSsastree(const bool printpolynomial, const int maxtreedepth) const;
 
-  void computeminnumFVS(const bool onlycomputemin, const bool nolist);
+  void computeminnumFVS(const bool onlycomputemin, const bool nolist, const bool enumerate);
 };
 
 #endif
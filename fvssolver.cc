@@ -0,0 +1,1105 @@
+// fvssolver.cc, the search split from digraph.cc (written by Kazuki Maeda <kmaeda at kmaeda.net>, 2020)
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include "nodeset.hh"
+#include "cycleset.hh"
+#include "fvssolver.hh"
+#include "threadpool.hh"
+
+using namespace std;
+
+// Print the line given by line(seconds since construction) to stderr every interval seconds
+// on a separate thread until destroyed (e.g., during a search).
+// The line is written to the buffer of std::cerr directly: std::cerr is tied to std::cout,
+// and writing to it would flush std::cout (buffered by outbuffer) while the search writes to it.
+class progressline {
+  mutex m;
+  condition_variable cv;
+  bool done;
+  thread t;
+
+public:
+  progressline(const double interval, const function<string(const double)>& line)
+    : done(false) {
+    t = thread([this, interval, line]{
+        auto start = chrono::steady_clock::now();
+        auto step = chrono::duration_cast<chrono::steady_clock::duration>(chrono::duration<double>(interval));
+        unique_lock<mutex> lk(m);
+        for(auto next = start + step; !cv.wait_until(lk, next, [this]{ return done; }); next += step){
+          auto s = "[progress] " + line(chrono::duration<double>(chrono::steady_clock::now() - start).count()) + "\n";
+          cerr.rdbuf()->sputn(s.data(), s.size());
+        }
+      });
+  }
+
+  ~progressline(){
+    {
+      lock_guard<mutex> lk(m);
+      done = true;
+    }
+    cv.notify_one();
+    t.join();
+  }
+};
+
+template<int W>
+class fvssolver : public fvssolverbase {
+  int numnodes;
+  vector<vector<int>> edges;    // edges[i] = {j0, j1, j2, ...}: i -> j
+  vector<nodeset<W>> cycles;    // cycles[i][j]: if node j is in cycle i
+                                // Note: this is the set of "local minimum" cycles (chordless cycles).
+                                // E.g., if there are cycles {1101} and {1001},
+                                // only {1001} is included in the cycles variable.
+  vector<vector<int>> members;  // members[i]: nodes in cycles[i]
+  vector<vector<uint64_t>> coverage; // bit i of coverage[j]: if node j is in cycle i
+  // Nodes in the same cycles are equivalent in the set cover problem, so that only one node
+  // of each class (the smallest one, called representative) is searched.
+  vector<vector<int>> classes;  // classes[i]: nodes in the class of i if i is a representative
+  bool expandclasses;
+
+  // State of the search. In parallel, each worker has its own buffer of FVSs,
+  // and the size of the smallest FVS found so far is shared by all workers.
+  // In minimize, only FVSs smaller than minnumFVS are searched and none is stored;
+  // if report is not null, FVSs are passed to it instead of being stored.
+  struct foundFVSs {
+    unsigned int size;
+    vector<vector<int>> FVSs;
+  };
+  const static int splitdepth = 3; // levels of the search tree run as separate tasks
+  atomic<unsigned int> minnumFVS;
+  vector<foundFVSs> found;
+  threadpool* pool;
+  bool onlymin;
+  const function<void(const vector<int>&)>* report;
+  mutex reportmutex;
+  bool packing, lp;
+  vector<unique_ptr<fvsbound>> lpbounds;        // for each worker
+  // lpnodes[worker][depth]: the selected and excluded nodes passed to lpbounds[worker],
+  // whose buffers are reused by the branches at the depth.
+  vector<vector<pair<vector<int>, vector<int>>>> lpnodes;
+  vector<unsigned long long> prunedbypacking, prunedbylp; // for each worker
+  vector<vector<vector<uint64_t>>> covered; // covered[worker][depth]: cycles covered by selected nodes
+  vector<unsigned long long> discarded;         // for each worker
+
+  // Profiling (see setprofile): visited[worker * stride] is the number of branches visited
+  // by the worker, read by progressline while the search runs; the counters are in different
+  // cache lines. The counters of the finished searches are summed in totals.
+  const static int stride = 8;
+  bool profile;
+  double progress;
+  unique_ptr<atomic<unsigned long long>[]> visited;
+  fvscounters totals;
+
+  // State of the search by splitting (see _solve), which runs on a single thread.
+  // A subproblem is to find all the minimum covers of a set of cycles without excluded nodes
+  // within a budget; the results are memoized until they take about memolimit bytes in total
+  // (the keys, the covers and memoentry bytes of the map, the string and the shared_ptr per entry).
+  struct subsolution {
+    unsigned int size;          // the size of minimum covers, or budget+1 if none within budget
+    unsigned int budget;
+    vector<vector<int>> covers;
+  };
+  const static size_t memolimit = 1 << 27;
+  const static size_t memoentry = 128;
+  const static unsigned int splitbudget = 2; // within smaller budgets, the search is cheaper than splitting
+  bool splitting;
+  unordered_map<string, shared_ptr<const subsolution>> memo;
+  size_t memosize;
+
+  void _detectcycles(const int start, const int i,
+                     const nodeset<W>& searched,
+                     nodeset<W>& path,
+                     cycleset<W>& found) const;
+  // Working arrays of _detectinducedcycles, allocated once for all the start nodes.
+  // The arrays indexed by nodes are reset by the search or marked with the start node.
+  struct inducedstate {
+    vector<int> blocked;          // the number of edges between the node and the path except start
+    vector<bool> inpath;
+    vector<int> reach;            // start if the node reaches start through nodes > start
+    vector<int> fromstart, tostart; // start if there is an edge start -> node (node -> start)
+    vector<pair<int, unsigned int>> stack; // the path except start: (node, next edge to be searched)
+    vector<int> queue;
+    explicit inducedstate(const int numnodes)
+      : blocked(numnodes), inpath(numnodes), reach(numnodes, -1),
+        fromstart(numnodes, -1), tostart(numnodes, -1) {}
+  };
+  void _detectinducedcycles(const int start,
+                            const vector<vector<int>>& redges,
+                            const vector<bool>& loop,
+                            inducedstate& state,
+                            vector<nodeset<W>>& found) const;
+  void _dfs(unsigned int cyclenum,
+            nodeset<W>& selected,
+            nodeset<W>& searched,
+            const int worker,
+            const int depth);
+  void search(threadpool* pool);
+  shared_ptr<const subsolution> _solve(const vector<uint64_t>& covered,
+                                      const nodeset<W>& excluded,
+                                      const unsigned int budget);
+
+  // Call f for each FVS obtained by replacing representatives in FVS with members of their classes.
+  template<class F>
+  void expand(const vector<int>& FVS, F f) const {
+    vector<int> x = FVS;
+    function<void(unsigned int)> choose = [&](const unsigned int k){
+      if(k == FVS.size()){
+        f(x);
+        return;
+      }
+      for(const auto& v: classes[FVS[k]]){
+        x[k] = v;
+        choose(k+1);
+      }
+    };
+    choose(0);
+  }
+
+  // Sort cycles by size, and lexicographically among those of the same size.
+  void sortcycles(){
+    sort(cycles.begin(), cycles.end(),
+         [](const nodeset<W>& x, const nodeset<W>& y)->bool{
+           auto nx = x.count(), ny = y.count();
+           return nx < ny || (nx == ny && x.lexless(y));
+         });
+  }
+  void addFVS(const nodeset<W>& selected, const int worker);
+  unsigned int packingbound(unsigned int cyclenum,
+                            const vector<uint64_t>& covered,
+                            const nodeset<W>& excluded,
+                            const unsigned int budget) const;
+
+  inline void countvisit(const int worker){
+    auto& v = visited[worker * stride];
+    v.store(v.load(memory_order_relaxed) + 1, memory_order_relaxed);
+  }
+
+  // The largest size of FVSs to be searched.
+  inline unsigned int currentbound() const {
+    auto bound = minnumFVS.load(memory_order_relaxed);
+    return onlymin && bound ? bound - 1 : bound;
+  }
+
+  // The first cycle not in covered from cyclenum (cycles.size() if none).
+  inline unsigned int nextuncovered(const vector<uint64_t>& covered, unsigned int cyclenum) const {
+    auto k = cyclenum / 64;
+    if(k >= covered.size())
+      return cycles.size();
+    auto w = ~covered[k] & (~uint64_t(0) << (cyclenum % 64));
+    while(!w){
+      if(++k == covered.size())
+        return cycles.size();
+      w = ~covered[k];
+    }
+    return min<unsigned int>(k * 64 + __builtin_ctzll(w), cycles.size());
+  }
+
+  // Does covered + (cycles containing node i) cover all the cycles from cyclenum?
+  inline bool coversrest(const vector<uint64_t>& covered, const int i, const unsigned int cyclenum) const {
+    auto k = cyclenum / 64;
+    if(k >= covered.size())
+      return true;
+    const auto& c = coverage[i];
+    auto w = ~(covered[k] | c[k]) & (~uint64_t(0) << (cyclenum % 64));
+    while(!w){
+      if(++k == covered.size())
+        return true;
+      w = ~(covered[k] | c[k]);
+    }
+    return k * 64 + __builtin_ctzll(w) >= cycles.size();
+  }
+
+  // The covered cycles at depth+1 when node i is selected at depth.
+  // The words before cyclenum are not looked at in the subtree of the search.
+  inline vector<uint64_t>& select(const int i, const int worker, const int depth,
+                                  const unsigned int cyclenum){
+    const auto& from = covered[worker][depth];
+    auto& to = covered[worker][depth+1];
+    to.resize(from.size());
+    const auto& c = coverage[i];
+    for(auto k = cyclenum / 64; k < to.size(); ++k)
+      to[k] = from[k] | c[k];
+    return to;
+  }
+
+public:
+  fvssolver(const int numnodes, const vector<vector<int>>& edges)
+    : numnodes(numnodes), edges(edges), expandclasses(true), minnumFVS(0), pool(nullptr),
+      onlymin(false), report(nullptr), packing(false), lp(false), profile(false), progress(0),
+      splitting(false), memosize(0) {}
+
+  void detectcycles(threadpool* pool);
+  void detectinducedcycles(threadpool* pool);
+  void dfs(unsigned int& minnumFVS, vector<vector<int>>& FVSs, threadpool* pool);
+  void minimize(unsigned int& minnumFVS, vector<int>& FVS, threadpool* pool);
+  bool addshortestcycles(const vector<int>& FVS);
+  void dfs(const unsigned int minnumFVS, const function<void(const vector<int>&)>& report,
+           threadpool* pool);
+
+  void setexpandclasses(const bool expand){
+    expandclasses = expand;
+  }
+
+  vector<int> classof(const int i) const {
+    return classes[i];
+  }
+
+  void setsplitting(const bool splitting){
+    this->splitting = splitting;
+  }
+
+  void setlowerbounds(const bool packing, const bool lp){
+    this->packing = packing;
+    this->lp = lp;
+  }
+
+  void prunedbranches(unsigned long long& packing, unsigned long long& lp) const {
+    packing = lp = 0;
+    for(const auto& n: prunedbypacking)
+      packing += n;
+    for(const auto& n: prunedbylp)
+      lp += n;
+  }
+
+  void setprofile(const bool profile, const double progress){
+    this->profile = profile;
+    this->progress = progress;
+  }
+
+  fvscounters counters() const {
+    return totals;
+  }
+
+  unsigned int numcycles() const {
+    return cycles.size();
+  }
+
+  vector<int> cycle(const unsigned int i) const {
+    return cycles[i].members();
+  }
+
+  unique_ptr<fvssolverbase> knockout(const vector<int>& removed) const;
+  vector<int> heuristicFVS() const;
+
+  void setcycles(const vector<vector<int>>& cycles){
+    this->cycles.assign(cycles.size(), nodeset<W>(numnodes));
+    for(unsigned int i = 0; i < cycles.size(); ++i)
+      for(const auto& v: cycles[i])
+        this->cycles[i].set(v);
+  }
+};
+
+template<int W>
+void fvssolver<W>::_detectcycles(const int start, const int i,
+                                 const nodeset<W>& searched,
+                                 nodeset<W>& path,
+                                 cycleset<W>& found) const {
+  path.set(i);
+  nodeset<W> nextsearched = searched;
+  for(const auto& v: edges[i])
+    nextsearched.set(v);        // prevent redundant search
+                                // E.g., if you have already found the path 0 -> 1,
+                                // then you can omit the path 0 -> 2 -> 1.
+  bool endflag = false;
+  bool cycleflag = false;
+  for(const auto& v: edges[i]){
+    if(v == start){
+      cycleflag = true;
+      break;
+    } else if(path[v]){
+      endflag = true; // If a branch returns to the node already passed,
+                      // all the results of further search will be redundant cycles.
+      break;
+    }
+  }
+
+  if(cycleflag){
+    if(path.any())
+      found.addandreduce(path); // leave only local minimum cycles
+  } else if(!endflag) {
+    for(const auto& v: edges[i]){
+      if(v < start || searched[v])
+        continue;
+      else
+        _detectcycles(start, v, nextsearched, path, found);
+    }
+  }
+  path.reset(i);
+}
+
+// Chordless cycles whose smallest node is start, in the manner of the enumeration of chordless
+// cycles by induced paths: a node w extends the path start -> v1 -> ... -> vk iff
+//  - w > start, w is not in the path, and w has no self-loop,
+//  - the only edge between w and v1, ..., vk is vk -> w (blocked[w] == 1),
+//  - there is no edge start -> w, and w reaches start (otherwise no cycle is closed).
+// The path is closed as a chordless cycle if w -> start; then it is not extended further,
+// where w -> start would be a chord. The search runs on an explicit stack without allocation
+// except for the cycles found.
+// A node with a self-loop is a chordless cycle by itself and is in no other chordless cycle.
+template<int W>
+void fvssolver<W>::_detectinducedcycles(const int start,
+                                        const vector<vector<int>>& redges,
+                                        const vector<bool>& loop,
+                                        inducedstate& state,
+                                        vector<nodeset<W>>& found) const {
+  if(loop[start]){
+    found.emplace_back(numnodes);
+    found.back().set(start);
+    return;
+  }
+  auto& queue = state.queue;
+  queue.assign(1, start);
+  state.reach[start] = start;
+  for(unsigned int k = 0; k < queue.size(); ++k)
+    for(const auto& u: redges[queue[k]])
+      if(u > start && !loop[u] && state.reach[u] != start){
+        state.reach[u] = start;
+        queue.push_back(u);
+      }
+  for(const auto& v: edges[start])
+    state.fromstart[v] = start;
+  for(const auto& v: redges[start])
+    state.tostart[v] = start;
+
+  auto& stack = state.stack;
+  auto push = [&](const int v){
+    state.inpath[v] = true;
+    for(const auto& u: edges[v])
+      ++state.blocked[u];
+    for(const auto& u: redges[v])
+      ++state.blocked[u];
+    stack.emplace_back(v, 0);
+  };
+  auto pop = [&]{
+    auto v = stack.back().first;
+    state.inpath[v] = false;
+    for(const auto& u: edges[v])
+      --state.blocked[u];
+    for(const auto& u: redges[v])
+      --state.blocked[u];
+    stack.pop_back();
+  };
+  auto close = [&](const int w){
+    found.emplace_back(numnodes);
+    auto& c = found.back();
+    c.set(start);
+    for(const auto& x: stack)
+      c.set(x.first);
+    c.set(w);
+  };
+  for(const auto& v: edges[start]){
+    if(v <= start || loop[v] || state.reach[v] != start)
+      continue;
+    if(state.tostart[v] == start){ // a cycle of two nodes
+      close(v);
+      continue;
+    }
+    push(v);
+    while(!stack.empty()){
+      auto u = stack.back().first;
+      auto& next = stack.back().second;
+      if(next == edges[u].size()){
+        pop();
+        continue;
+      }
+      auto w = edges[u][next++];
+      if(w <= start || loop[w] || state.inpath[w] || state.blocked[w] != 1 ||
+         state.fromstart[w] == start || state.reach[w] != start)
+        continue;
+      if(state.tostart[w] == start)
+        close(w);
+      else
+        push(w);
+    }
+  }
+}
+
+template<int W>
+void fvssolver<W>::detectcycles(threadpool* pool){
+  unsigned long long tried = 0;
+  if(!pool){
+    cycleset<W> found(numnodes);
+    nodeset<W> path(numnodes);
+    for(auto i = 0; i < numnodes; ++i){
+      nodeset<W> searched(numnodes);
+      searched.set(i);
+      _detectcycles(i, i, searched, path, found);
+    }
+    cycles = found.extract();
+    tried = found.tried();
+  } else {
+    // The search from each start node is independent of the others.
+    // Each worker reduces the cycles it has found, and they are merged below.
+    vector<cycleset<W>> found(pool->size(), cycleset<W>(numnodes));
+    for(auto i = 0; i < numnodes; ++i)
+      pool->submit([this, i, &found](const int id){
+          nodeset<W> path(numnodes), searched(numnodes);
+          searched.set(i);
+          _detectcycles(i, i, searched, path, found[id]);
+        });
+    pool->wait();
+    cycles.clear();
+    for(const auto& f: found){
+      auto c = f.extract();
+      cycles.insert(cycles.end(), c.cbegin(), c.cend());
+      tried += f.tried();
+    }
+  }
+  // The order of cycles does not depend on the order of detection.
+  sortcycles();
+  if(pool){
+    // A subset of a cycle comes before it, so that no cycle is removed here.
+    cycleset<W> merged(numnodes);
+    for(const auto& c: cycles)
+      merged.addandreduce(c);
+    cycles = merged.extract();
+  }
+  totals.candidatecycles += tried;
+  totals.rejectedcycles += tried - cycles.size();
+}
+
+template<int W>
+void fvssolver<W>::detectinducedcycles(threadpool* pool){
+  vector<vector<int>> redges(numnodes);
+  vector<bool> loop(numnodes);
+  for(auto i = 0; i < numnodes; ++i)
+    for(const auto& j: edges[i]){
+      redges[j].push_back(i);
+      if(i == j)
+        loop[i] = true;
+    }
+  if(!pool){
+    inducedstate state(numnodes);
+    cycles.clear();
+    for(auto i = 0; i < numnodes; ++i)
+      _detectinducedcycles(i, redges, loop, state, cycles);
+  } else {
+    vector<inducedstate> states(pool->size(), inducedstate(numnodes));
+    vector<vector<nodeset<W>>> found(pool->size());
+    for(auto i = 0; i < numnodes; ++i)
+      pool->submit([this, i, &redges, &loop, &states, &found](const int id){
+          _detectinducedcycles(i, redges, loop, states[id], found[id]);
+        });
+    pool->wait();
+    cycles.clear();
+    for(const auto& f: found)
+      cycles.insert(cycles.end(), f.cbegin(), f.cend());
+  }
+  sortcycles();
+  totals.candidatecycles += cycles.size();
+}
+
+// Solve set cover problem by simple DFS.
+// depth is the number of selected nodes, and covered[worker][depth] is the set of
+// cycles covered by them, which is made from that of the parent when a node is selected.
+// The branches at the top splitdepth levels are submitted to the pool as tasks if any.
+template<int W>
+void fvssolver<W>::_dfs(unsigned int cyclenum,
+                        nodeset<W>& selected,
+                        nodeset<W>& searched,
+                        const int worker,
+                        const int depth) {
+  if(profile)
+    countvisit(worker);
+  const auto& cov = covered[worker][depth];
+  cyclenum = nextuncovered(cov, cyclenum);
+  if(cyclenum == cycles.size()){
+    addFVS(selected, worker);
+    return;
+  }
+
+  const unsigned int n = depth;
+  auto bound = currentbound();
+  if(n >= bound)
+    return;
+  nodeset<W> nextsearched = searched;
+  // prune if selected + (lower bound of the rest) > minnumFVS
+  if(packing && packingbound(cyclenum, cov, nextsearched, bound - n) > bound - n){
+    ++prunedbypacking[worker];
+    return;
+  }
+  if(lpbounds[worker]){
+    auto& sel = lpnodes[worker][depth].first;
+    auto& excl = lpnodes[worker][depth].second;
+    sel.clear();
+    excl.clear();
+    nextsearched.foreach([&](const int v){ (selected[v] ? sel : excl).push_back(v); });
+    if(lpbounds[worker]->bound(sel, excl) > bound - n){
+      ++prunedbylp[worker];
+      return;
+    }
+  }
+
+  for(const auto& i: members[cyclenum])
+    if(!nextsearched[i]){
+      selected.set(i);
+      nextsearched.set(i);   // prevent duplicate listing
+      if(n + 1 >= currentbound()){
+        // The child is either a leaf or pruned.
+        if(coversrest(cov, i, cyclenum+1))
+          addFVS(selected, worker);
+      } else if(pool && depth < splitdepth)
+        pool->submit([this, cyclenum, selected, nextsearched, depth](const int id) mutable {
+            auto& cov = covered[id][depth+1];
+            cov.assign(coverage.empty() ? 0 : coverage[0].size(), 0);
+            selected.foreach([&](const int v){
+                for(unsigned int k = 0; k < cov.size(); ++k)
+                  cov[k] |= coverage[v][k];
+              });
+            _dfs(cyclenum+1, selected, nextsearched, id, depth+1);
+          }, worker);
+      else {
+        select(i, worker, depth, cyclenum);
+        _dfs(cyclenum+1, selected, nextsearched, worker, depth+1);
+      }
+      selected.reset(i);
+    }
+}
+
+// Find all the minimum covers of the cycles not in covered without excluded nodes within budget.
+//  - The cycles are split into groups sharing no node except excluded ones (if budget > splitbudget),
+//    which are solved separately; the covers are the products of those of groups.
+//  - Otherwise, the first cycle is covered by each of its nodes in turn (as _dfs),
+//    where the nodes tried before are excluded to prevent duplicates.
+//  - The results are memoized by the set of cycles and the excluded nodes in them;
+//    "none within budget" is reused only for smaller budgets.
+template<int W>
+shared_ptr<const typename fvssolver<W>::subsolution>
+fvssolver<W>::_solve(const vector<uint64_t>& covered,
+                     const nodeset<W>& excluded,
+                     const unsigned int budget){
+  if(profile)
+    countvisit(0);
+  auto sol = make_shared<subsolution>();
+  sol->size = budget + 1;
+  sol->budget = budget;
+  auto first = nextuncovered(covered, 0);
+  if(first == cycles.size()){
+    sol->size = 0;
+    sol->covers.assign(1, vector<int>());
+    return sol;
+  }
+  auto n = packingbound(first, covered, excluded, packing ? budget : 0);
+  if(n == numeric_limits<unsigned int>::max() || !budget)
+    return sol;
+  if(packing && n > budget){
+    ++prunedbypacking[0];
+    return sol;
+  }
+
+  string key;
+  {
+    auto k = covered;
+    excluded.foreach([&](const int v){
+        for(unsigned int j = 0; j < covered.size(); ++j)
+          if(coverage[v][j] & ~covered[j]){
+            k.push_back(v);
+            break;
+          }
+      });
+    key.assign(reinterpret_cast<const char*>(k.data()), k.size() * sizeof(uint64_t));
+  }
+  auto it = memo.find(key);
+  if(it != memo.end()){
+    const auto& m = *it->second;
+    if(m.size <= m.budget && m.size <= budget)
+      return it->second;
+    if(m.size > budget)
+      return sol;
+  }
+
+  // groups of cycles connected by nodes, each given as the cycles not in it
+  vector<vector<uint64_t>> groups;
+  if(budget > splitbudget){
+    auto grouped = covered;
+    nodeset<W> visited = excluded;
+    for(auto v = 0; v < numnodes; ++v)  // nodes only in covered cycles
+      if(!visited[v]){
+        unsigned int j = 0;
+        while(j < covered.size() && !(coverage[v][j] & ~covered[j]))
+          ++j;
+        if(j == covered.size())
+          visited.set(v);
+      }
+    for(auto c = first; c < cycles.size(); c = nextuncovered(grouped, c)){
+      vector<uint64_t> g(grouped.size());
+      g[c / 64] |= uint64_t(1) << (c % 64);
+      for(bool changed = true; changed; ){
+        changed = false;
+        for(auto v = 0; v < numnodes; ++v)
+          if(!visited[v]){
+            unsigned int j = 0;
+            while(j < g.size() && !(coverage[v][j] & g[j]))
+              ++j;
+            if(j < g.size()){
+              visited.set(v);
+              for(j = 0; j < g.size(); ++j)
+                g[j] |= coverage[v][j] & ~covered[j];
+              changed = true;
+            }
+          }
+      }
+      for(unsigned int j = 0; j < g.size(); ++j){
+        grouped[j] |= g[j];
+        g[j] = ~g[j];
+      }
+      groups.push_back(move(g));
+    }
+  }
+
+  if(groups.size() > 1){
+    // each of the remaining groups needs at least as many nodes as its packed cycles
+    unsigned int size = 0, remaining = 0;
+    vector<unsigned int> needs;
+    for(const auto& g: groups){
+      needs.push_back(packing ? packingbound(0, g, excluded, budget) : 1);
+      if(needs.back() > budget)
+        return sol;
+      remaining += needs.back();
+    }
+    sol->covers.assign(1, vector<int>());
+    auto need = needs.cbegin();
+    for(const auto& g: groups){
+      remaining -= *need++;
+      if(size + remaining >= budget){
+        sol->covers.clear();
+        return sol;
+      }
+      auto r = _solve(g, excluded, budget - size - remaining);
+      if(r->size > r->budget){
+        sol->covers.clear();
+        return sol;
+      }
+      size += r->size;
+      vector<vector<int>> product;
+      product.reserve(sol->covers.size() * r->covers.size());
+      for(const auto& x: sol->covers)
+        for(const auto& y: r->covers){
+          product.push_back(x);
+          product.back().insert(product.back().end(), y.cbegin(), y.cend());
+        }
+      sol->covers.swap(product);
+    }
+    sol->size = size;
+  } else {
+    nodeset<W> nextexcluded = excluded;
+    vector<uint64_t> rest(covered.size());
+    for(const auto& i: members[first])
+      if(!nextexcluded[i]){
+        for(unsigned int j = 0; j < rest.size(); ++j)
+          rest[j] = covered[j] | coverage[i][j];
+        // covers of the size of the smallest so far are also listed
+        auto r = _solve(rest, nextexcluded, min(budget, sol->size) - 1);
+        if(r->size <= r->budget){
+          if(r->size + 1 < sol->size){
+            sol->size = r->size + 1;
+            sol->covers.clear();
+          }
+          for(const auto& x: r->covers){
+            sol->covers.push_back(x);
+            sol->covers.back().push_back(i);
+          }
+        }
+        nextexcluded.set(i);
+      }
+  }
+
+  // failed subproblems have no covers, but their keys count
+  size_t total = memoentry + sizeof(subsolution) + key.size();
+  for(const auto& x: sol->covers)
+    total += sizeof(x) + x.size() * sizeof(int);
+  if(memosize + total > memolimit){
+    memo.clear();
+    memosize = 0;
+  }
+  memo[key] = sol;
+  memosize += total;
+  return sol;
+}
+
+// Greedily pack uncovered cycles which share no node except excluded ones.
+// Each of them needs a distinct node, so that the number of them is a lower bound.
+// The packing stops when it exceeds budget.
+template<int W>
+unsigned int fvssolver<W>::packingbound(unsigned int cyclenum,
+                                        const vector<uint64_t>& covered,
+                                        const nodeset<W>& excluded,
+                                        const unsigned int budget) const {
+  nodeset<W> used(numnodes);
+  unsigned int n = 0;
+  for(; (cyclenum = nextuncovered(covered, cyclenum)) < cycles.size(); ++cyclenum){
+    const auto& c = cycles[cyclenum];
+    if(c.issubsetof(excluded))  // cannot be covered
+      return numeric_limits<unsigned int>::max();
+    if(!c.intersectsexcept(used, excluded)){
+      used.unionexcept(c, excluded);
+      if(++n > budget)
+        break;
+    }
+  }
+  return n;
+}
+
+template<int W>
+void fvssolver<W>::addFVS(const nodeset<W>& selected, const int worker){
+  unsigned int n = selected.count();
+  auto bound = minnumFVS.load();
+  while(n < bound && !minnumFVS.compare_exchange_weak(bound, n))
+    ;
+  if(onlymin){
+    if(n < bound)               // the smallest so far
+      found[worker] = foundFVSs{n, {selected.members()}};
+    return;
+  }
+  if(n > bound)                 // another worker has found a smaller FVS
+    return;
+  if(report){
+    lock_guard<mutex> lk(reportmutex);
+    if(expandclasses)
+      expand(selected.members(), [&](const vector<int>& x){ (*report)(x); });
+    else
+      (*report)(selected.members());
+    return;
+  }
+  auto& f = found[worker];
+  if(n < f.size){
+    f.size = n;
+    discarded[worker] += f.FVSs.size();
+    f.FVSs.clear();
+  }
+  f.FVSs.push_back(selected.members());
+}
+
+// Run _dfs from the root with the bound this->minnumFVS.
+template<int W>
+void fvssolver<W>::search(threadpool* pool){
+  nodeset<W> selected(numnodes), searched(numnodes);
+  unsigned int bound = minnumFVS;
+  this->pool = pool;
+  auto numworkers = pool ? pool->size() : 1;
+  found.assign(numworkers, foundFVSs{bound, {}});
+  prunedbypacking.assign(numworkers, 0);
+  prunedbylp.assign(numworkers, 0);
+  discarded.assign(numworkers, 0);
+  visited.reset(new atomic<unsigned long long>[numworkers * stride]());
+  lpbounds.clear();
+  for(auto k = 0; k < numworkers; ++k)
+    lpbounds.push_back(lp && !splitting ? newlpbound(*this) : nullptr); // not used by _solve
+  unique_ptr<progressline> line;
+  if(progress > 0)
+    line.reset(new progressline(progress, [this, numworkers](const double t){
+        ostringstream os;
+        os << fixed << setprecision(1) << t << " s: " << cycles.size() << " cycles, bound = "
+           << minnumFVS.load(memory_order_relaxed);
+        if(profile){
+          unsigned long long n = 0;
+          for(auto k = 0; k < numworkers; ++k)
+            n += visited[k * stride].load(memory_order_relaxed);
+          os << ", " << n << " branches visited";
+        }
+        return os.str();
+      }));
+  auto sumcounters = [&]{
+    for(auto k = 0; k < numworkers; ++k){
+      totals.visited += visited[k * stride].load(memory_order_relaxed);
+      totals.prunedbypacking += prunedbypacking[k];
+      totals.prunedbylp += prunedbylp[k];
+      totals.discarded += discarded[k];
+    }
+  };
+  auto numwords = (cycles.size() + 63) / 64;
+  members.resize(cycles.size());
+  coverage.assign(numnodes, vector<uint64_t>(numwords));
+  for(unsigned int c = 0; c < cycles.size(); ++c){
+    members[c] = cycles[c].members();
+    for(const auto& v: members[c])
+      coverage[v][c / 64] |= uint64_t(1) << (c % 64);
+  }
+  // The other members of classes are excluded from the search.
+  map<vector<uint64_t>, int> reps;
+  classes.assign(numnodes, vector<int>());
+  for(auto v = 0; v < numnodes; ++v)
+    if(any_of(coverage[v].cbegin(), coverage[v].cend(), [](const uint64_t w){ return w != 0; })){
+      auto r = reps.emplace(coverage[v], v).first->second;
+      classes[r].push_back(v);
+      if(r != v)
+        searched.set(v);
+    }
+  for(auto& m: members)
+    m.erase(remove_if(m.begin(), m.end(), [&](const int v){ return classes[v].empty(); }),
+            m.end());
+  if(splitting){
+    vector<uint64_t> none(numwords);
+    if(cycles.size() % 64)      // the bits after the last cycle are regarded as covered
+      none.back() = ~uint64_t(0) << (cycles.size() % 64);
+    auto r = _solve(none, searched, min<unsigned int>(currentbound(), numnodes));
+    if(r->size <= r->budget)
+      for(const auto& c: r->covers){
+        for(const auto& v: c)
+          selected.set(v);
+        addFVS(selected, 0);
+        selected.reset();
+      }
+    memo.clear();
+    memosize = 0;
+    lpbounds.clear();
+    sumcounters();
+    return;
+  }
+  // A branch selects at most minnumFVS nodes.
+  covered.assign(numworkers, vector<vector<uint64_t>>(min<unsigned int>(bound, numnodes) + 1));
+  for(auto& c: covered)
+    c[0].assign(numwords, 0);
+  if(lp)
+    lpnodes.assign(numworkers, vector<pair<vector<int>, vector<int>>>(covered[0].size()));
+  if(pool){
+    pool->submit([&](const int id){ _dfs(0, selected, searched, id, 0); });
+    pool->wait();
+  } else
+    _dfs(0, selected, searched, 0, 0);
+  lpbounds.clear();
+  lpnodes.clear();
+  covered.clear();
+  sumcounters();
+}
+
+template<int W>
+void fvssolver<W>::dfs(unsigned int& minnumFVS, vector<vector<int>>& FVSs, threadpool* pool){
+  this->minnumFVS = minnumFVS;
+  onlymin = false;
+  report = nullptr;
+  search(pool);
+
+  minnumFVS = this->minnumFVS;
+  FVSs.clear();
+  for(auto& f: found)
+    if(f.size != minnumFVS)     // smaller FVSs have been found by another worker
+      totals.discarded += f.FVSs.size();
+    else
+      for(auto& x: f.FVSs){
+        if(expandclasses)
+          expand(x, [&](const vector<int>& y){
+              FVSs.push_back(y);
+              sort(FVSs.back().begin(), FVSs.back().end());
+            });
+        else
+          FVSs.push_back(move(x));
+      }
+  found.clear();
+  if(pool){
+    sort(FVSs.begin(), FVSs.end());
+    FVSs.erase(unique(FVSs.begin(), FVSs.end()), FVSs.end());
+  }
+}
+
+template<int W>
+void fvssolver<W>::minimize(unsigned int& minnumFVS, vector<int>& FVS, threadpool* pool){
+  this->minnumFVS = minnumFVS;
+  onlymin = true;
+  report = nullptr;
+  search(pool);
+  onlymin = false;
+  minnumFVS = this->minnumFVS;
+  FVS.clear();
+  for(auto& f: found)
+    if(f.size == minnumFVS && !f.FVSs.empty())
+      FVS = f.FVSs.front();
+  found.clear();
+}
+
+template<int W>
+unique_ptr<fvssolverbase> fvssolver<W>::knockout(const vector<int>& removed) const {
+  nodeset<W> r(numnodes);
+  for(const auto& v: removed)
+    r.set(v);
+  auto s = new fvssolver<W>(numnodes, edges);
+  for(auto i = 0; i < numnodes; ++i)
+    if(r[i])
+      s->edges[i].clear();
+    else
+      s->edges[i].erase(remove_if(s->edges[i].begin(), s->edges[i].end(),
+                                  [&](const int j){ return r[j]; }),
+                        s->edges[i].end());
+  for(const auto& c: cycles)   // the order is kept
+    if(!c.intersects(r))
+      s->cycles.push_back(c);
+  s->setlowerbounds(packing, lp);
+  s->setsplitting(splitting);
+  s->setprofile(profile, progress);
+  return unique_ptr<fvssolverbase>(s);
+}
+
+// Greedily select the node in the most uncovered cycles until all the cycles are covered.
+// Then, improve the cover by local search:
+//  - remove a node whose cycles are all covered by the others,
+//  - replace two nodes u and v with one node in all the cycles covered only by u or v.
+template<int W>
+vector<int> fvssolver<W>::heuristicFVS() const {
+  vector<vector<int>> incidence(numnodes); // cycles containing each node
+  for(unsigned int c = 0; c < cycles.size(); ++c)
+    cycles[c].foreach([&](const int v){ incidence[v].push_back(c); });
+  vector<unsigned int> hits(cycles.size()); // the number of selected nodes in each cycle
+  vector<bool> selected(numnodes);
+  auto select = [&](const int v, const bool s){
+    selected[v] = s;
+    for(const auto& c: incidence[v])
+      if(s)
+        ++hits[c];
+      else
+        --hits[c];
+  };
+
+  vector<unsigned int> gain(numnodes);
+  priority_queue<pair<unsigned int, int>> queue; // (gain, -node), possibly outdated
+  for(auto v = 0; v < numnodes; ++v){
+    gain[v] = incidence[v].size();
+    if(gain[v])
+      queue.emplace(gain[v], -v);
+  }
+  auto uncovered = cycles.size();
+  while(uncovered){
+    auto v = -queue.top().second;
+    auto g = queue.top().first;
+    queue.pop();
+    if(g != gain[v]){
+      queue.emplace(gain[v], -v);
+      continue;
+    }
+    select(v, true);
+    for(const auto& c: incidence[v])
+      if(hits[c] == 1){
+        --uncovered;
+        cycles[c].foreach([&](const int u){ --gain[u]; });
+      }
+  }
+
+  auto redundant = [&](const int v){
+    return all_of(incidence[v].cbegin(), incidence[v].cend(),
+                  [&](const int c){ return hits[c] > 1; });
+  };
+  vector<int> need;
+  for(bool improved = true; improved; ){
+    improved = false;
+    for(auto v = 0; v < numnodes; ++v)
+      if(selected[v] && redundant(v))
+        select(v, false);
+    for(auto u = 0; u < numnodes && !improved; ++u)
+      for(auto v = u + 1; v < numnodes && selected[u] && !improved; ++v){
+        if(!selected[v])
+          continue;
+        need.clear();
+        for(const auto& c: incidence[u])
+          if(hits[c] == 1 || (hits[c] == 2 && cycles[c][v]))
+            need.push_back(c);
+        for(const auto& c: incidence[v])
+          if(hits[c] == 1)
+            need.push_back(c);
+        cycles[need[0]].foreach([&](const int w){
+            if(improved || selected[w])
+              return;
+            if(all_of(need.cbegin(), need.cend(), [&](const int c){ return cycles[c][w]; })){
+              select(u, false);
+              select(v, false);
+              select(w, true);
+              improved = true;
+            }
+          });
+      }
+  }
+
+  vector<int> FVS;
+  for(auto v = 0; v < numnodes; ++v)
+    if(selected[v])
+      FVS.push_back(v);
+  return FVS;
+}
+
+// Shortest cycles are found by BFS from each node in the network without FVS.
+// They are merged into cycles, and supersets are removed as in detectcycles.
+template<int W>
+bool fvssolver<W>::addshortestcycles(const vector<int>& FVS){
+  vector<bool> removed(numnodes), oncycle(numnodes);
+  for(const auto& v: FVS)
+    removed[v] = true;
+  cycleset<W> found(numnodes);
+  for(const auto& c: cycles)
+    found.addandreduce(c);
+  vector<int> parent(numnodes, -1), queue;
+  bool added = false;
+  for(auto s = 0; s < numnodes; ++s){
+    if(removed[s] || oncycle[s])
+      continue;
+    queue.assign(1, s);
+    parent[s] = s;
+    auto last = -1;           // the last node of the cycle (last -> s)
+    for(unsigned int k = 0; k < queue.size() && last < 0; ++k){
+      auto u = queue[k];
+      for(const auto& w: edges[u])
+        if(w == s){
+          last = u;
+          break;
+        } else if(!removed[w] && parent[w] < 0){
+          parent[w] = u;
+          queue.push_back(w);
+        }
+    }
+    if(last >= 0){
+      nodeset<W> c(numnodes);
+      for(auto u = last; ; u = parent[u]){
+        c.set(u);
+        oncycle[u] = true;
+        if(u == s)
+          break;
+      }
+      found.addandreduce(c);
+      added = true;
+    }
+    for(const auto& u: queue)
+      parent[u] = -1;
+  }
+  if(added){
+    cycles = found.extract();
+    sortcycles();
+  }
+  return added;
+}
+
+template<int W>
+void fvssolver<W>::dfs(const unsigned int minnumFVS,
+                       const function<void(const vector<int>&)>& report,
+                       threadpool* pool){
+  this->minnumFVS = minnumFVS;
+  onlymin = false;
+  this->report = &report;
+  search(pool);
+  this->report = nullptr;
+  found.clear();
+}
+
+// Fast paths for networks with up to 64, 256 and 1024 nodes.
+unique_ptr<fvssolverbase> newfvssolver(const int numnodes,
+                                       const vector<vector<int>>& edges){
+  if(numnodes <= 64)
+    return unique_ptr<fvssolverbase>(new fvssolver<1>(numnodes, edges));
+  else if(numnodes <= 256)
+    return unique_ptr<fvssolverbase>(new fvssolver<4>(numnodes, edges));
+  else if(numnodes <= 1024)
+    return unique_ptr<fvssolverbase>(new fvssolver<16>(numnodes, edges));
+  else
+    return unique_ptr<fvssolverbase>(new fvssolver<0>(numnodes, edges));
+}
@@ -0,0 +1,109 @@
+// fvssolver.hh, the search split from digraph.cc (written by Kazuki Maeda <kmaeda at kmaeda.net>, 2020)
+
+#ifndef _FVSSOLVER_HH_
+#define _FVSSOLVER_HH_
+
+#include <functional>
+#include <vector>
+#include <memory>
+
+class threadpool;
+class fvsbound;
+
+// Counters of the work of a solver, summed over its cycle detection and searches.
+struct fvscounters {
+  unsigned long long candidatecycles = 0; // cycles passed to the minimality check by detectcycles
+  unsigned long long rejectedcycles = 0;  // of them, those rejected or removed as not local minimum
+  unsigned long long visited = 0;         // branches of the search visited (only if profiled)
+  unsigned long long prunedbypacking = 0, prunedbylp = 0;
+  unsigned long long discarded = 0;       // FVSs stored and discarded when a smaller FVS was found
+};
+
+// Interface of the solver of the FVS problem.
+// The actual solver fvssolver<W> (see fvssolver.cc) stores node sets in W words;
+// newfvssolver chooses W from the number of nodes.
+class fvssolverbase {
+public:
+  virtual ~fvssolverbase() {}
+
+  // Detect chordless cycles. If pool is not null, the searches from
+  // different start nodes are run on the pool.
+  virtual void detectcycles(threadpool* pool) = 0;
+  // The same cycles as detectcycles, enumerated directly by extending induced paths,
+  // so that no cycle is found and rejected by the minimality check.
+  virtual void detectinducedcycles(threadpool* pool) = 0;
+  virtual unsigned int numcycles() const = 0;
+  virtual std::vector<int> cycle(const unsigned int i) const = 0; // sorted list of nodes in the i-th cycle
+  // Instead of detecting all the cycles, add the shortest cycle through each node of
+  // the network without the nodes in FVS (except the nodes in the cycles just added).
+  // Returns false if there is no such cycle, i.e., FVS is an FVS of the network.
+  virtual bool addshortestcycles(const std::vector<int>& FVS) = 0;
+  // Instead of detectcycles, set the cycles detected before (e.g., in a cache file),
+  // given in the order of cycle(i).
+  virtual void setcycles(const std::vector<std::vector<int>>& cycles) = 0;
+  // A solver of the network without the removed nodes (left as isolated nodes).
+  // The chordless cycles of the network without them are exactly the chordless cycles
+  // not containing them, so that they are taken from this without detection.
+  virtual std::unique_ptr<fvssolverbase> knockout(const std::vector<int>& removed) const = 0;
+
+  // An FVS (list of nodes) of the detected cycles found by a greedy heuristic with local search,
+  // whose size is an upper bound of the size of minimal FVSs.
+  virtual std::vector<int> heuristicFVS() const = 0;
+
+  // Enumerate all the minimal FVSs whose sizes are at most minnumFVS.
+  // minnumFVS is updated to the size of minimal FVSs,
+  // and each FVS is stored as a sorted list of nodes.
+  // If pool is not null, the branches of the search are run on the pool.
+  virtual void dfs(unsigned int& minnumFVS, std::vector<std::vector<int>>& FVSs,
+                   threadpool* pool) = 0;
+  // Only compute the size of minimal FVSs, where minnumFVS is an upper bound (exclusive).
+  // One minimal FVS is stored in FVS if one smaller than the bound is found.
+  virtual void minimize(unsigned int& minnumFVS, std::vector<int>& FVS, threadpool* pool) = 0;
+  // Pass each minimal FVS to report as soon as it is found instead of storing it,
+  // where minnumFVS must be the size of minimal FVSs (e.g., computed by minimize).
+  // report is called by one thread at a time.
+  virtual void dfs(const unsigned int minnumFVS,
+                   const std::function<void(const std::vector<int>&)>& report,
+                   threadpool* pool) = 0;
+
+  // Nodes in the same cycles are grouped into classes, and only one node (representative)
+  // of each class is searched. The minimal FVSs given by dfs are expanded to all the members
+  // of the classes unless expand is false; then they consist of representatives.
+  virtual void setexpandclasses(const bool expand) = 0;
+  // The members of the class represented by node i in the last search.
+  virtual std::vector<int> classof(const int i) const = 0;
+
+  // Search by splitting the uncovered cycles into independent groups with memoization
+  // instead of the branch and bound by _dfs (on a single thread; see fvssolver<W>::_solve).
+  virtual void setsplitting(const bool splitting) = 0;
+
+  // Lower bounds used to prune branches of dfs:
+  // packing: the number of uncovered cycles which share no node (greedily packed),
+  // lp: LP relaxation of the set cover problem of uncovered cycles (see newlpbound).
+  virtual void setlowerbounds(const bool packing, const bool lp) = 0;
+  // The numbers of branches pruned by the lower bounds in the last dfs.
+  virtual void prunedbranches(unsigned long long& packing, unsigned long long& lp) const = 0;
+
+  // Count the visited branches of the searches (the other counters are always kept),
+  // and if progress > 0, print a progress line to stderr every progress seconds during a search.
+  virtual void setprofile(const bool profile, const double progress) = 0;
+  virtual fvscounters counters() const = 0;
+};
+
+// A lower bound of the number of nodes to be added to selected nodes in order to
+// cover all the cycles, where excluded nodes must not be added.
+// An instance is used by one thread at a time.
+class fvsbound {
+public:
+  virtual ~fvsbound() {}
+  virtual unsigned int bound(const std::vector<int>& selected, const std::vector<int>& excluded) = 0;
+};
+
+// The lower bound by LP relaxation for the cycles of solver.
+// Defined in searchfvs_withcbc.cc; it returns null without Cbc.
+std::unique_ptr<fvsbound> newlpbound(const fvssolverbase& solver);
+
+std::unique_ptr<fvssolverbase> newfvssolver(const int numnodes,
+                                            const std::vector<std::vector<int>>& edges);
+
+#endif
@@ -0,0 +1,80 @@
+// mappedfile.hh, written by Kazuki Maeda <kmaeda at kmaeda.net>, 2020
+
+#ifndef _MAPPEDFILE_HH_
+#define _MAPPEDFILE_HH_
+
+#include <cerrno>
+#include <string>
+#include <vector>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+// Read-only view of the whole contents of a file.
+// The file is mapped by mmap if possible; otherwise (e.g., a pipe)
+// it is read into a buffer.
+class mappedfile {
+  const char* addr;
+  size_t len;
+  bool mapped;
+  std::vector<char> buf;
+
+  mappedfile(const mappedfile&) = delete;
+  mappedfile& operator=(const mappedfile&) = delete;
+
+public:
+  mappedfile() : addr(nullptr), len(0), mapped(false) {}
+
+  ~mappedfile(){
+    close();
+  }
+
+  // Returns false and sets errno on failure.
+  bool open(const std::string& filename){
+    close();
+    int fd = ::open(filename.c_str(), O_RDONLY);
+    if(fd < 0)
+      return false;
+    struct stat st;
+    if(fstat(fd, &st) == 0 && S_ISREG(st.st_mode) && st.st_size > 0){
+      void* p = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+      if(p != MAP_FAILED){
+        madvise(p, st.st_size, MADV_SEQUENTIAL);
+        addr = static_cast<const char*>(p);
+        len = st.st_size;
+        mapped = true;
+        ::close(fd);
+        return true;
+      }
+    }
+    // fallback
+    char tmp[65536];
+    ssize_t n;
+    while((n = ::read(fd, tmp, sizeof(tmp))) > 0)
+      buf.insert(buf.end(), tmp, tmp+n);
+    int e = errno;
+    ::close(fd);
+    if(n < 0){
+      errno = e;
+      return false;
+    }
+    addr = buf.data();
+    len = buf.size();
+    return true;
+  }
+
+  void close(){
+    if(mapped)
+      munmap(const_cast<char*>(addr), len);
+    addr = nullptr;
+    len = 0;
+    mapped = false;
+    buf.clear();
+  }
+
+  inline const char* data() const { return addr; }
+  inline size_t size() const { return len; }
+};
+
+#endif
@@ -0,0 +1,70 @@
+// nametable.hh, written by Kazuki Maeda <kmaeda at kmaeda.net>, 2020
+
+#ifndef _NAMETABLE_HH_
+#define _NAMETABLE_HH_
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+
+// Hash table (open addressing) from names to their indices in a vector of names.
+// Names can be looked up by a pointer and a length, so that a parser
+// need not construct std::string for each token.
+class nametable {
+  const std::vector<std::string>& names;
+  std::vector<int> slots;       // index of names, or -1 if empty
+  int numentries;
+
+  inline static uint64_t hash(const char* s, const size_t len){
+    uint64_t h = 14695981039346656037ULL; // FNV-1a
+    for(size_t k = 0; k < len; ++k){
+      h ^= (unsigned char)s[k];
+      h *= 1099511628211ULL;
+    }
+    return h;
+  }
+
+  inline size_t probe(const char* s, const size_t len) const {
+    auto mask = slots.size() - 1;
+    auto k = hash(s, len) & mask;
+    while(slots[k] >= 0){
+      const auto& n = names[slots[k]];
+      if(n.length() == len && !memcmp(n.data(), s, len))
+        break;
+      k = (k + 1) & mask;
+    }
+    return k;
+  }
+
+public:
+  explicit nametable(const std::vector<std::string>& names)
+    : names(names), slots(16, -1), numentries(0) {
+    for(int i = 0; i < (int)names.size(); ++i)
+      insert(i);
+  }
+
+  // Index of the name, or -1 if not registered.
+  inline int find(const char* s, const size_t len) const {
+    return slots[probe(s, len)];
+  }
+
+  inline int find(const std::string& s) const {
+    return find(s.data(), s.length());
+  }
+
+  // Register names[i].
+  inline void insert(const int i){
+    if(2 * (numentries + 1) > (int)slots.size()){
+      std::vector<int> old(slots.size() * 2, -1);
+      old.swap(slots);
+      for(const auto& j: old)
+        if(j >= 0)
+          slots[probe(names[j].data(), names[j].length())] = j;
+    }
+    slots[probe(names[i].data(), names[i].length())] = i;
+    ++numentries;
+  }
+};
+
+#endif
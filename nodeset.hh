@@ -0,0 +1,152 @@
+// nodeset.hh, written by Kazuki Maeda <kmaeda at kmaeda.net>, 2020
+
+#ifndef _NODESET_HH_
+#define _NODESET_HH_
+
+#include <cstdint>
+#include <vector>
+
+// Storage of nodeset: W 64-bit words are held inline.
+// W = 0 means that the number of words is decided at runtime.
+template<int W>
+struct _nodesetwords {
+  uint64_t w[W];
+  explicit _nodesetwords(const int) : w() {}
+  int numwords() const { return W; }
+};
+
+template<>
+struct _nodesetwords<0> {
+  std::vector<uint64_t> w;
+  explicit _nodesetwords(const int numnodes) : w((numnodes+63)/64) {}
+  int numwords() const { return w.size(); }
+};
+
+// A set of nodes {0, 1, ..., numnodes-1}.
+// This replaces std::bitset<maxnumnodes>: the width is chosen when the network
+// has been read (see newfvssolver), so small networks touch only a few words
+// and large networks need no recompile.
+template<int W>
+class nodeset : private _nodesetwords<W> {
+  using _nodesetwords<W>::w;
+
+public:
+  using _nodesetwords<W>::numwords;
+
+  explicit nodeset(const int numnodes) : _nodesetwords<W>(numnodes) {}
+
+  inline bool operator[](const int i) const {
+    return (w[i >> 6] >> (i & 63)) & 1;
+  }
+
+  inline void set(const int i) {
+    w[i >> 6] |= uint64_t(1) << (i & 63);
+  }
+
+  inline void reset(const int i) {
+    w[i >> 6] &= ~(uint64_t(1) << (i & 63));
+  }
+
+  inline void reset() {
+    for(auto k = 0; k < numwords(); ++k)
+      w[k] = 0;
+  }
+
+  inline int count() const {
+    auto n = 0;
+    for(auto k = 0; k < numwords(); ++k)
+      n += __builtin_popcountll(w[k]);
+    return n;
+  }
+
+  inline bool any() const {
+    for(auto k = 0; k < numwords(); ++k)
+      if(w[k])
+        return true;
+    return false;
+  }
+
+  inline bool none() const {
+    return !any();
+  }
+
+  // (*this & x).any()
+  inline bool intersects(const nodeset& x) const {
+    for(auto k = 0; k < numwords(); ++k)
+      if(w[k] & x.w[k])
+        return true;
+    return false;
+  }
+
+  // (*this & x & ~except).any()
+  inline bool intersectsexcept(const nodeset& x, const nodeset& except) const {
+    for(auto k = 0; k < numwords(); ++k)
+      if(w[k] & x.w[k] & ~except.w[k])
+        return true;
+    return false;
+  }
+
+  // (*this | x) == x
+  inline bool issubsetof(const nodeset& x) const {
+    for(auto k = 0; k < numwords(); ++k)
+      if(w[k] & ~x.w[k])
+        return false;
+    return true;
+  }
+
+  // Call f(i) for each node i in the set in ascending order.
+  template<class F>
+  inline void foreach(F f) const {
+    for(auto k = 0; k < numwords(); ++k)
+      for(auto b = w[k]; b; b &= b - 1)
+        f((k << 6) + __builtin_ctzll(b));
+  }
+
+  inline std::vector<int> members() const {
+    std::vector<int> m;
+    foreach([&](const int i){ m.push_back(i); });
+    return m;
+  }
+
+  inline nodeset& operator|=(const nodeset& x) {
+    for(auto k = 0; k < numwords(); ++k)
+      w[k] |= x.w[k];
+    return *this;
+  }
+
+  // *this |= x & ~except
+  inline void unionexcept(const nodeset& x, const nodeset& except) {
+    for(auto k = 0; k < numwords(); ++k)
+      w[k] |= x.w[k] & ~except.w[k];
+  }
+
+  inline nodeset& operator&=(const nodeset& x) {
+    for(auto k = 0; k < numwords(); ++k)
+      w[k] &= x.w[k];
+    return *this;
+  }
+
+  inline bool operator==(const nodeset& x) const {
+    for(auto k = 0; k < numwords(); ++k)
+      if(w[k] != x.w[k])
+        return false;
+    return true;
+  }
+
+  inline bool operator!=(const nodeset& x) const {
+    return !(*this == x);
+  }
+
+  // Order of sets of the same size: the set having the smallest node
+  // which differs comes first (i.e., lexicographic order of the member lists).
+  inline bool lexless(const nodeset& x) const {
+    for(auto k = 0; k < numwords(); ++k)
+      if(w[k] != x.w[k]){
+        auto d = w[k] ^ x.w[k];
+        return (w[k] >> __builtin_ctzll(d)) & 1;
+      }
+    return false;
+  }
+};
+
+#endif
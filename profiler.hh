@@ -0,0 +1,70 @@
+// profiler.hh, written by Kazuki Maeda <kmaeda at kmaeda.net>, 2020
+
+#ifndef _PROFILER_HH_
+#define _PROFILER_HH_
+
+#include <chrono>
+#include <ctime>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+#include <sys/resource.h>
+
+// Wall-clock and CPU time of the phases of a run (for --profile).
+// Nothing is measured if it is disabled.
+class profiler {
+  struct phase {
+    std::string name;
+    double wall, cpu;           // in seconds; cpu is of all the threads
+  };
+  bool enabled;
+  std::vector<phase> phases;
+  std::string current;
+  std::chrono::steady_clock::time_point wallstart;
+  std::clock_t cpustart;
+
+public:
+  explicit profiler(const bool enabled) : enabled(enabled), cpustart(0) {}
+
+  // End the current phase (if any) and start the next one.
+  void start(const std::string& name){
+    if(!enabled)
+      return;
+    stop();
+    current = name;
+    wallstart = std::chrono::steady_clock::now();
+    cpustart = std::clock();
+  }
+
+  void stop(){
+    if(current.empty())
+      return;
+    std::chrono::duration<double> wall = std::chrono::steady_clock::now() - wallstart;
+    phases.push_back(phase{current, wall.count(), double(std::clock() - cpustart) / CLOCKS_PER_SEC});
+    current.clear();
+  }
+
+  // Print the times of the phases and the peak memory (resident set size).
+  void output(std::ostream& os){
+    if(!enabled)
+      return;
+    stop();
+    double wall = 0, cpu = 0;
+    os << "Profile:" << std::endl;
+    os << std::fixed << std::setprecision(3);
+    for(const auto& p: phases){
+      os << "  " << std::left << std::setw(12) << p.name << std::right
+         << " wall " << std::setw(9) << p.wall << " s, CPU " << std::setw(9) << p.cpu << " s" << std::endl;
+      wall += p.wall;
+      cpu += p.cpu;
+    }
+    os << "  " << std::left << std::setw(12) << "total" << std::right
+       << " wall " << std::setw(9) << wall << " s, CPU " << std::setw(9) << cpu << " s" << std::endl;
+    struct rusage usage;
+    if(!getrusage(RUSAGE_SELF, &usage))
+      os << "#[peak memory (kB)] = " << usage.ru_maxrss << std::endl; // in kilobytes on Linux
+  }
+};
+
+#endif
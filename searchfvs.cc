@@ -5,12 +5,18 @@
 #include <string>
 #include <fstream>
 #include <cstring>
+#include <cstdio>
 #include <cstdlib>
 #include <sstream>
 #include <algorithm>
+#include <limits>
+#include <mutex>
+#include <utility>
+#include <vector>
 #include <errno.h>
 #include <getopt.h>
 
+#include "profiler.hh"
 #include "searchfvs.hh"
 
 using namespace std;
@@ -20,8 +26,25 @@ int main(int argc, char** argv){
   bool printcycles = false, printhelp = false, nosearch = false;
   bool nolist = false;
   bool printstat = false, printpolynomial = false, printtree = false;
-  int maxtreedepth = digraph::maxnumnodes; // used by outputFVSsastree
+  int maxtreedepth = numeric_limits<int>::max(); // used by outputFVSsastree
   bool onlycomputemin = false;
+  bool reduce = false;
+  bool stream = false;
+  bool enumeratebycbc = false;
+  bool lazycycles = false;
+  string cyclecache;            // file name given by --cycle-cache
+  string knockouts;             // file name given by --knockout
+  bool classes = false;
+  bool split = false;
+  bool countonly = false;
+  bool profile = false;
+  double progress = 0;          // seconds given by --progress
+  outputformat format = outputformat::text;
+  string convertto;             // file name given by --convert
+  bool inducedcycles = false;
+  string manifest;              // file name given by --batch
+  int numthreads = 1;
+  bool packingbound = true, lpbound = false, printbound = false;
   vector<string> removenodelist; // List of nodes specified by --remove-node .
 
   struct option long_options[] =
@@ -36,6 +59,23 @@ int main(int argc, char** argv){
      {"print-tree", no_argument, NULL, 't'},
      {"max-tree-depth", required_argument, NULL, 1000},
      {"only-compute-min", no_argument, NULL, 1002},
+     {"reduce", no_argument, NULL, 1003},
+     {"threads", required_argument, NULL, 1004},
+     {"lower-bound", required_argument, NULL, 1005},
+     {"stream", no_argument, NULL, 1006},
+     {"enumerate-by-cbc", no_argument, NULL, 1007},
+     {"lazy-cycles", no_argument, NULL, 1008},
+     {"cycle-cache", required_argument, NULL, 1009},
+     {"knockout", required_argument, NULL, 1010},
+     {"classes", no_argument, NULL, 1011},
+     {"split", no_argument, NULL, 1012},
+     {"count-only", no_argument, NULL, 1013},
+     {"profile", no_argument, NULL, 1014},
+     {"progress", required_argument, NULL, 1015},
+     {"format", required_argument, NULL, 1016},
+     {"convert", required_argument, NULL, 1017},
+     {"cycle-engine", required_argument, NULL, 1018},
+     {"batch", required_argument, NULL, 1019},
      {0, 0, 0, 0}
     };
 
@@ -76,16 +116,149 @@ int main(int argc, char** argv){
         printhelp = true;
       }
       break;
+    case 1003:                // --reduce
+      reduce = true;
+      break;
+    case 1004:                // --threads
+      numthreads = atoi(optarg);
+      break;
+    case 1005:                // --lower-bound
+      if(!printbound)
+        packingbound = lpbound = false;
+      printbound = true;
+      if(!strcmp(optarg, "packing"))
+        packingbound = true;
+      else if(!strcmp(optarg, "lp") && withcbc)
+        lpbound = true;
+      else if(strcmp(optarg, "none")){
+        cerr << "Error: unknown lower bound \"" << optarg << "\"." << endl;
+        printhelp = true;
+      }
+      break;
+    case 1006:                // --stream
+      stream = true;
+      break;
+    case 1007:                // --enumerate-by-cbc
+      if(withcbc)
+        enumeratebycbc = true;
+      else {
+        cerr << "Error: This is not \"withcbc\" version; cannot specify --enumerate-by-cbc option." << endl;
+        printhelp = true;
+      }
+      break;
+    case 1008:                // --lazy-cycles
+      lazycycles = true;
+      break;
+    case 1009:                // --cycle-cache
+      cyclecache = optarg;
+      break;
+    case 1010:                // --knockout
+      knockouts = optarg;
+      break;
+    case 1011:                // --classes
+      classes = true;
+      break;
+    case 1012:                // --split
+      split = true;
+      break;
+    case 1013:                // --count-only
+      countonly = true;
+      break;
+    case 1014:                // --profile
+      profile = true;
+      break;
+    case 1015:                // --progress
+      progress = atof(optarg);
+      if(progress <= 0){
+        cerr << "Error: the interval of --progress must be positive." << endl;
+        printhelp = true;
+      }
+      break;
+    case 1016:                // --format
+      if(!strcmp(optarg, "text"))
+        format = outputformat::text;
+      else if(!strcmp(optarg, "tsv"))
+        format = outputformat::tsv;
+      else if(!strcmp(optarg, "jsonl"))
+        format = outputformat::jsonl;
+      else if(!strcmp(optarg, "binary"))
+        format = outputformat::binary;
+      else {
+        cerr << "Error: unknown format \"" << optarg << "\"." << endl;
+        printhelp = true;
+      }
+      break;
+    case 1017:                // --convert
+      convertto = optarg;
+      break;
+    case 1018:                // --cycle-engine
+      if(!strcmp(optarg, "search"))
+        inducedcycles = false;
+      else if(!strcmp(optarg, "induced"))
+        inducedcycles = true;
+      else {
+        cerr << "Error: unknown cycle engine \"" << optarg << "\"." << endl;
+        printhelp = true;
+      }
+      break;
+    case 1019:                // --batch
+      manifest = optarg;
+      break;
     }
   }
 
-  if(printhelp || argc - optind < 1){
+  if(stream && printtree){
+    cerr << "Error: --stream cannot be used with --print-tree." << endl;
+    printhelp = true;
+  }
+  if(!knockouts.empty() && (reduce || lazycycles || countonly || stream)){
+    cerr << "Error: --knockout cannot be used with --reduce, --lazy-cycles, --count-only or --stream." << endl;
+    printhelp = true;
+  }
+  if(classes && (reduce || stream || enumeratebycbc)){
+    cerr << "Error: --classes cannot be used with --reduce, --stream or --enumerate-by-cbc." << endl;
+    printhelp = true;
+  }
+  if(split && lpbound){
+    cerr << "Error: --split cannot be used with --lower-bound lp." << endl;
+    printhelp = true;
+  }
+  if(stream && enumeratebycbc){
+    cerr << "Error: --stream cannot be used with --enumerate-by-cbc." << endl;
+    printhelp = true;
+  }
+  if(countonly && (stream || enumeratebycbc || printtree || printpolynomial)){
+    cerr << "Error: --count-only cannot be used with --stream, --enumerate-by-cbc, --print-tree or --print-polynomial." << endl;
+    printhelp = true;
+  }
+
+  if(format != outputformat::text && (printtree || printpolynomial || classes || !knockouts.empty())){
+    cerr << "Error: --format other than text cannot be used with --print-tree, --print-polynomial, --classes or --knockout." << endl;
+    printhelp = true;
+  }
+
+  if(!convertto.empty() && !removenodelist.empty()){
+    cerr << "Error: --convert cannot be used with --remove-node (nodes are removed when the binary file is read)." << endl;
+    printhelp = true;
+  }
+
+  if(!manifest.empty() && (profile || progress > 0 || !cyclecache.empty() || !convertto.empty())){
+    cerr << "Error: --batch cannot be used with --profile, --progress, --cycle-cache or --convert." << endl;
+    printhelp = true;
+  }
+
+  if(printhelp || argc - optind != (manifest.empty() ? 1 : 0)){
     cerr << "Usage: " << argv[0] << " [options] <network file>" << endl;
+    cerr << "       " << argv[0] << " [options] --batch <manifest>" << endl;
     cerr << "Options:" << endl;
     cerr << "  -h or --help                Print this message and exit." << endl;
     cerr << "  -n or --no-search           Don't search minimal FVSs (use with --print-cycles)." << endl;
     if(withcbc)
       cerr << "  --only-compute-min          Only compute the mininum number of FVS, print a minimal FVS, and exit." << endl;
+    if(withcbc){
+      cerr << "  --enumerate-by-cbc          Enumerate minimal FVSs by Cbc instead of the search by DFS (a branch and" << endl;
+      cerr << "                              bound from scratch per FVS, only for networks with few minimal FVSs)." << endl;
+    }
     cerr << "  --no-list                   Don't show list of chordless cycles and minimal FVSs." << endl;
     cerr << "  -c or --print-cycles        Print the set of chordless cycles at the head." << endl;
     cerr << "  -t or --print-tree          Print the tree list of minimal FVSs." << endl;
@@ -93,52 +266,246 @@ int main(int argc, char** argv){
     cerr << "  -p or --print-polynomial    Print the list of minimal FVSs as a polynomial." << endl;
     cerr << "  -s or --print-stat          Print statistics of minimal FVSs." << endl;
     cerr << "  -r or --remove-node <node>  Remove specified node." << endl;
+    cerr << "  --threads <number>          Use specified number of threads." << endl;
+    cerr << "  --lower-bound <bound>       Prune the search by specified lower bound (packing" << (withcbc ? ", lp" : "") << " or none;" << endl;
+    cerr << "                              can be repeated; default: packing), and print the number of pruned branches" << endl;
+    cerr << "                              and the size of the FVS found by the heuristic (upper bound; in the profile" << endl;
+    cerr << "                              with --profile)." << endl;
+    cerr << "  --reduce                    Reduce the network before searching (chordless cycles are of the reduced network)." << endl;
+    cerr << "  --lazy-cycles               Only compute the mininum number of FVS and print a minimal FVS, adding shortest cycles" << endl;
+    cerr << "                              until the solution is an FVS (without detecting all the chordless cycles), and exit." << endl;
+    cerr << "  --cycle-engine <engine>     Detect chordless cycles by search (default; non-chordless cycles found are" << endl;
+    cerr << "                              removed) or induced (only induced paths are extended; the same cycles)." << endl;
+    cerr << "  --cycle-cache <file>        Read chordless cycles from the file if it is of the same network;" << endl;
+    cerr << "                              otherwise, detect them and write them to the file." << endl;
+    cerr << "  --knockout <file>           For each line of the file (nodes to be removed), print the size and" << endl;
+    cerr << "                              the number of minimal FVSs of the network without the nodes, and exit" << endl;
+    cerr << "                              (not with --reduce, --lazy-cycles, --count-only or --stream)." << endl;
+    cerr << "  --classes                   Group nodes in the same chordless cycles into a class shown as {A|B|C}," << endl;
+    cerr << "                              and list minimal FVSs (and statistics) of classes, which are not expanded" << endl;
+    cerr << "                              in the list, the polynomial or the tree (not with --reduce, --stream or" << endl;
+    cerr << "                              --enumerate-by-cbc). Without --classes, all the FVSs are expanded" << endl;
+    cerr << "                              (one by one as they are found with --stream)." << endl;
+    cerr << "  --split                     Split the search into independent groups of cycles with memoization" << endl;
+    cerr << "                              (not with --lower-bound lp)." << endl;
+    cerr << "                              The search runs on one thread regardless of --threads." << endl;
+    cerr << "  --count-only                Only print the number of minimal FVSs (and statistics with --print-stat)" << endl;
+    cerr << "                              counted without storing them." << endl;
+    cerr << "  --stream                    Print minimal FVSs as soon as they are found (unsorted; not with --print-tree)." << endl;
+    cerr << "  --profile                   Print the wall-clock and CPU time of each phase, the peak memory, the size of" << endl;
+    cerr << "                              the FVS found by the heuristic and the counters of the search (cycles, branches," << endl;
+    cerr << "                              discarded FVSs) to stderr." << endl;
+    cerr << "  --progress <seconds>        Print a progress line of the search to stderr at the specified interval." << endl;
+    cerr << "  --convert <file>            Write the network to the file in the binary format, which is read" << endl;
+    cerr << "                              faster than the text (the input file is detected), and exit." << endl;
+    cerr << "  --format <format>           Print the results as text (default), or as records of node indices" << endl;
+    cerr << "                              in tsv, jsonl or binary (see writer.hh)." << endl;
+    cerr << "  --batch <manifest>          Solve the networks listed in the manifest (a network file and optionally" << endl;
+    cerr << "                              its result file, <network file>.out by default, per line) concurrently" << endl;
+    cerr << "                              with the specified number of threads, and print the status of each." << endl;
     return 1;
   }
 
-  // init
-  digraph dg;
+  if(!convertto.empty())
+    return digraph::convert(argv[optind], convertto);
 
-  // read
-  auto s = dg.read(argv[optind], removenodelist);
-  if(s)
-    return s;
+  // Solve the network in filename with numthreads threads, and print the results to out and
+  // the warnings and diagnostics to err. The options are only read, so that networks can be
+  // solved concurrently.
+  auto run = [&](const string& filename, const int numthreads, ostream& out, ostream& err){
+    // init
+    digraph dg;
+    dg.setoutput(out, err);
+    dg.setnumthreads(numthreads);
+    dg.setlowerbounds(packingbound, lpbound);
+    dg.setsplitting(split);
+    dg.setinducedcycles(inducedcycles);
+    dg.setprofile(profile, progress);
+    dg.setcompressclasses(classes);
+    dg.setformat(format);
 
-  dg.outputremovednodes();
-  dg.detectcycles();
+    // Each phase is timed if --profile is specified; the profile is printed at exit.
+    profiler prof(profile);
+    auto finish = [&](const int status){
+      if(profile){
+        prof.output(err);
+        dg.outputprofile();
+      }
+      return status;
+    };
 
-  // print cycles (if --print-cycles specified)
-  if(printcycles)
-    dg.outputcycles(nolist);
+    // read
+    prof.start("read");
+    auto s = dg.read(filename, removenodelist);
+    if(s)
+      return s;
 
-  // search minimal FVSs
-  if(!nosearch){
-    if(withcbc){
-      dg.computeminnumFVS(onlycomputemin, nolist);
-      if(onlycomputemin)
-        return 0;
+    if(format == outputformat::text)
+      dg.outputremovednodes();
+    else
+      dg.outputnodes();
+    if(reduce){
+      prof.start("reduce");
+      dg.reduce();
+    }
+    if(lazycycles){
+      prof.start("lazy-cycles");
+      dg.computeminnumFVSlazily(nolist);
+      return finish(0);
+    }
+    prof.start("cycles");
+    if(cyclecache.empty() || !dg.loadcycles(cyclecache)){
+      dg.detectcycles();
+      if(!cyclecache.empty())
+        dg.savecycles(cyclecache);
+    }
+    if(!knockouts.empty()){
+      prof.start("heuristic");
+      dg.estimateminnumFVS();
+      prof.start("knockout");
+      return finish(dg.screenknockouts(knockouts));
     }
-    dg.dfs();
-    dg.calcstatFVS();
-
-    // output
-    if(!withcbc)
-      dg.outputheader();
-    if(!nolist){
-      if(printtree){
-        dg.outputFVSsastree(printpolynomial, maxtreedepth);
-        cout << endl;
+
+    // print cycles (if --print-cycles specified)
+    if(printcycles){
+      prof.start("output");
+      dg.outputcycles(nolist);
+    }
+
+    // search minimal FVSs
+    if(!nosearch){
+      prof.start("heuristic");
+      dg.estimateminnumFVS();
+      prof.start("search");
+      if(withcbc){
+        dg.computeminnumFVS(onlycomputemin, nolist, enumeratebycbc);
+        if(onlycomputemin)
+          return finish(0);
+      }
+      if(countonly){
+        dg.countFVSs();
+        prof.start("output");
+        if(!withcbc)
+          dg.outputheader();
+        if(printbound)
+          dg.outputprunedbranches();
+        dg.outputcounts(printstat);
+        return finish(0);
+      }
+      if(stream){
+        dg.minimize();
+        if(!withcbc)
+          dg.outputheader();
+        prof.start("stream");
+        dg.streamFVSs(nolist, printpolynomial);
+        if(printbound)
+          dg.outputprunedbranches();
+        if(!nolist && printstat)
+          dg.outputstat();
+        return finish(0);
+      }
+      if(!enumeratebycbc)
+        dg.dfs();
+      if(printbound)
+        dg.outputprunedbranches();
+      prof.start("stats");
+      s = dg.calcstatFVS();
+      if(s)
+        return finish(s);
+
+      // output
+      if(!withcbc)
+        dg.outputheader();
+      if(!nolist){
+        prof.start("expand");
+        s = dg.expandFVSs();
+        if(s)
+          return finish(s);
+        prof.start("output");
+        if(printtree){
+          dg.outputFVSsastree(printpolynomial, maxtreedepth);
+          out << '\n';
+        }
+        else if(printpolynomial)
+          dg.outputFVSsaspolynomial();
+        else
+          dg.outputFVSs();
+
+        // print stat. (if --print-stat specified)
+        if(printstat)
+          dg.outputstat();
       }
-      else if(printpolynomial)
-        dg.outputFVSsaspolynomial();
-      else
-        dg.outputFVSs();
-
-      // print stat. (if --print-stat specified)
-      if(printstat)
-        dg.outputstat();
     }
+
+    return finish(0);
+  };
+
+  if(manifest.empty()){
+    // The output is flushed when the buffer is full and at exit, not at each line.
+    outbuffer buffer(cout);
+    return run(argv[optind], numthreads, cout, cerr);
+  }
+
+  // batch: each network is solved by a single thread, and its warnings and diagnostics
+  // are printed at once when it has been solved, with its name at the head of each line
+  // (once).
+  ifstream fin(manifest);
+  if(!fin){
+    cerr << manifest << ": " << strerror(errno) << endl;
+    return 1;
   }
+  vector<pair<string, string>> jobs;    // network file, result file
+  string line;
+  while(getline(fin, line)){
+    istringstream is(line);
+    string network, result;
+    if(!(is >> network) || network[0] == '#')
+      continue;
+    if(!(is >> result))
+      result = network + ".out";
+    jobs.emplace_back(network, result);
+  }
+  vector<int> status(jobs.size());
+  mutex m;
+  auto solve = [&](const int j){
+    ostringstream err;
+    ofstream ofs(jobs[j].second, ios::binary);
+    if(!ofs){
+      err << jobs[j].second << ": " << strerror(errno) << endl;
+      status[j] = 1;
+    } else {
+      status[j] = run(jobs[j].first, 1, ofs, err);
+      ofs.close();
+      if(!ofs){
+        err << "Error: cannot write " << jobs[j].second << "." << endl;
+        status[j] = 1;
+      }
+      if(status[j])             // no partial results are left
+        remove(jobs[j].second.c_str());
+    }
+    istringstream lines(err.str());
+    string l;
+    lock_guard<mutex> lk(m);
+    const auto prefix = jobs[j].first + ":";
+    while(getline(lines, l))
+      if(l.compare(0, prefix.length(), prefix))
+        cerr << prefix << ' ' << l << endl;
+      else                      // already with the name (e.g., errors of reading)
+        cerr << l << endl;
+  };
+  if(numthreads > 1){
+    threadpool pool(numthreads);
+    for(unsigned int j = 0; j < jobs.size(); ++j)
+      pool.submit([&, j](const int){ solve(j); });
+    pool.wait();
+  } else
+    for(unsigned int j = 0; j < jobs.size(); ++j)
+      solve(j);
 
-  return 0;
+  int failed = 0;
+  for(unsigned int j = 0; j < jobs.size(); ++j){
+    cout << jobs[j].first << '\t' << jobs[j].second << '\t' << (status[j] ? "error" : "ok") << '\n';
+    failed += status[j] != 0;
+  }
+  return failed ? 1 : 0;
 }
@@ -3,7 +3,6 @@
 #ifndef _SEARCHFVS_HH_
 #define _SEARCHFVS_HH_
 
-#include <bitset>
 #include <vector>
 
 #include "digraph.hh"
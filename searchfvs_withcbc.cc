@@ -1,5 +1,8 @@
 // searchfvs_withcbc.cc, written by Kazuki Maeda <kmaeda at kmaeda.net>, 2020
 
+#include <cmath>
+#include <limits>
+#include <numeric>
 #include <coin/CbcModel.hpp>
 #include <coin/OsiClpSolverInterface.hpp>
 
@@ -9,23 +12,22 @@ using namespace std;
 
 const bool withcbc = true;
 
-// Solve set cover problem by COINOR Cbc solver.
-void digraph::computeminnumFVS(const bool onlycomputemin, const bool nolist){
-  bitset<maxnumnodes> FVS;
+// Load the LP relaxation of the set cover problem of the cycles (nodes {0, ..., numcols-1})
+// to solver, and return numcols.
+static int loadsetcover(const fvssolverbase& cycles, OsiClpSolverInterface& solver){
   // construct the coefficient matrix of ILP
   vector<int> rowinds, colinds;
   vector<double> els;
   auto numels = 0;
-  int numrows = cycles.size();
+  int numrows = cycles.numcycles();
   // count nonzero elements
   for(auto i = 0; i < numrows; ++i){
-    for(auto j = 0; j < numnodes; ++j)
-      if(cycles[i][j]){
-        rowinds.push_back(i);
-        colinds.push_back(j);
-        els.push_back(1);
-        ++numels;
-      }
+    for(const auto& j: cycles.cycle(i)){
+      rowinds.push_back(i);
+      colinds.push_back(j);
+      els.push_back(1);
+      ++numels;
+    }
   }
   CoinPackedMatrix coefmat(true, &rowinds[0], &colinds[0], &els[0], numels);
 
@@ -41,16 +43,22 @@ void digraph::computeminnumFVS(const bool onlycomputemin, const bool nolist){
   vector<double> objcoefs, collows, colups;
   for(auto j = 0; j < numcols; ++j){
     objcoefs.push_back(1);
-    // all variables are in {0, 1}
+    // all variables are in [0, 1]
     collows.push_back(0);
     colups.push_back(1);
   }
 
+  solver.setLogLevel(0);        // no log message
+  solver.loadProblem(coefmat, &collows[0], &colups[0], &objcoefs[0], &rowlows[0], &rowups[0]);
+  return numcols;
+}
 
+// Solve set cover problem by COINOR Cbc solver.
+// The cycles of solver are covered by nodes {0, ..., numcols-1}; a solution is stored in FVS.
+static unsigned int solvesetcover(const fvssolverbase& cycles, vector<int>& FVS){
   // LP relaxation solver
   OsiClpSolverInterface solver;
-  solver.setLogLevel(0);        // no log message
-  solver.loadProblem(coefmat, &collows[0], &colups[0], &objcoefs[0], &rowlows[0], &rowups[0]);
+  auto numcols = loadsetcover(cycles, solver);
   // set all variables as interger
   for(auto j = 0; j < numcols; ++j)
     solver.setInteger(j);
@@ -66,29 +74,129 @@ void digraph::computeminnumFVS(const bool onlycomputemin, const bool nolist){
 
   // Warning: error check should be inserted here
 
-  minnumFVS = model.getObjValue();
-
-  // Is there any way to get all solutions by CBC?
-  // The code below will give only one solution.
+  // The code below will give only one solution (see enumeratesetcover for all of them).
   const double *solution = model.getColSolution();
-  FVS.reset();
+  FVS.clear();
+  for(auto j = 0; j < numcols; ++j)
+    if(solution[j] > 0.5)
+      FVS.push_back(j);
+
+  return model.getObjValue() + 0.5;
+}
+
+// Enumerate all the solutions of the set cover problem of size minnumFVS by Cbc.
+// The size is fixed by a constraint, and each solution found is excluded by
+// a no-good cut (the sum of its variables <= minnumFVS - 1) before the next solve.
+// The cuts are added to the same LP, whose relaxation is re-solved from the previous basis,
+// but the branch and bound of each solve starts from scratch: the enumeration takes
+// as many branch and bounds as minimal FVSs (see --help).
+static void enumeratesetcover(const fvssolverbase& cycles, const unsigned int minnumFVS,
+                              vector<vector<int>>& FVSs){
+  OsiClpSolverInterface solver;
+  auto numcols = loadsetcover(cycles, solver);
   for(auto j = 0; j < numcols; ++j)
-    if(solution[j])
-      FVS.set(j);
+    solver.setInteger(j);
+  vector<int> inds(numcols);
+  iota(inds.begin(), inds.end(), 0);
+  vector<double> ones(numcols, 1);
+  solver.addRow(CoinPackedVector(numcols, &inds[0], &ones[0]), minnumFVS, minnumFVS);
+  solver.initialSolve();
+
+  FVSs.clear();
+  while(solver.isProvenOptimal()){
+    CbcModel model(solver);
+    model.setLogLevel(0);
+    model.solver()->setHintParam(OsiDoReducePrint);
+    model.branchAndBound();
+    if(!model.isProvenOptimal()) // no more solution
+      break;
+    const double *solution = model.getColSolution();
+    vector<int> FVS;
+    for(auto j = 0; j < numcols; ++j)
+      if(solution[j] > 0.5)
+        FVS.push_back(j);
+    solver.addRow(CoinPackedVector(FVS.size(), &FVS[0], &ones[0]), -COIN_DBL_MAX, FVS.size() - 1.0);
+    FVSs.push_back(move(FVS));
+    solver.resolve();
+  }
+}
+
+// Lower bound by the LP relaxation solved by Clp.
+// The variables of selected nodes are fixed to 1 and those of excluded nodes to 0.
+// Only the changed bounds are updated from the previous call, and
+// the LP is re-solved from the previous basis.
+class lpbound : public fvsbound {
+  OsiClpSolverInterface solver;
+  int numcols;
+  vector<char> state, nextstate; // 0: free, 1: selected, 2: excluded
+
+public:
+  explicit lpbound(const fvssolverbase& cycles){
+    numcols = loadsetcover(cycles, solver);
+    solver.initialSolve();
+    state.assign(numcols, 0);
+  }
+
+  unsigned int bound(const vector<int>& selected, const vector<int>& excluded){
+    nextstate.assign(numcols, 0);
+    for(const auto& v: excluded)
+      if(v < numcols)
+        nextstate[v] = 2;
+    for(const auto& v: selected)
+      if(v < numcols)
+        nextstate[v] = 1;
+    for(auto j = 0; j < numcols; ++j)
+      if(nextstate[j] != state[j]){
+        solver.setColLower(j, nextstate[j] == 1 ? 1 : 0);
+        solver.setColUpper(j, nextstate[j] == 2 ? 0 : 1);
+      }
+    state.swap(nextstate);
+    solver.resolve();
+    if(solver.isProvenPrimalInfeasible())
+      return numeric_limits<unsigned int>::max();
+    if(!solver.isProvenOptimal())
+      return 0;
+    auto lb = ceil(solver.getObjValue() - 1e-6) - selected.size();
+    return lb > 0 ? lb : 0;
+  }
+};
+
+unique_ptr<fvsbound> newlpbound(const fvssolverbase& solver){
+  return unique_ptr<fvsbound>(new lpbound(solver));
+}
+
+// The set cover problem is solved for each SCC.
+// If enumerate, all the minimal FVSs of each SCC are also enumerated by Cbc (instead of dfs).
+void digraph::computeminnumFVS(const bool onlycomputemin, const bool nolist, const bool enumerate){
+  vector<int> FVS = forced;
+  minnumFVS = forced.size();
+  for(auto& c: components){
+    vector<int> cFVS;
+    c.minnumFVS = solvesetcover(*c.solver, cFVS);
+    minnumFVS += c.minnumFVS;
+    for(const auto& v: cFVS)
+      FVS.push_back(c.nodes[v]);
+    if(enumerate && !onlycomputemin)
+      enumeratesetcover(*c.solver, c.minnumFVS, c.FVSs);
+  }
+  sort(FVS.begin(), FVS.end());
 
   outputheader();
   if(onlycomputemin){
     if(nolist)
       return;
+    if(format != outputformat::text){
+      recordwriter(*results, format).FVS(FVS.data(), FVS.size());
+      return;
+    }
     unsigned int tmp = 1;
-    cout << "A minimal FVS: ";
-    for(int i = 0; i < numnodes; ++i)
-      if(FVS[i]){
-        cout << nodes[i];
-        if(tmp < minnumFVS)
-          cout << ", ";
-        ++tmp;
-      }
-    cout << endl;
+    *results << "A minimal FVS: ";
+    for(const auto& i: FVS){
+      *results << nodes[i];
+      if(tmp < minnumFVS)
+        *results << ", ";
+      ++tmp;
+    }
+    *results << '\n';
   }
 }
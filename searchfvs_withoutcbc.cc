@@ -5,4 +5,5 @@
 using namespace std;
 
 const bool withcbc = false;
-void digraph::computeminnumFVS(const bool, const bool){}
+void digraph::computeminnumFVS(const bool, const bool, const bool){}
+unique_ptr<fvsbound> newlpbound(const fvssolverbase&){ return nullptr; }
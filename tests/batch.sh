@@ -0,0 +1,34 @@
+#!/bin/sh
+# Check that --batch solves two networks (with a given result file and with the default one)
+# concurrently, and that the result of each is the same as a separate run with the same options,
+# and that a missing network is reported as an error without affecting the others.
+# Usage: tests/batch.sh <searchfvs binary>
+
+. "$(dirname "$0")/common.sh"
+
+fail(){
+  echo "FAIL: --batch $1" >&2
+  exit 1
+}
+
+networks
+printf '%s\n' "$TMP/ciona.txt $TMP/ciona.result" "# comment" "$TMP/random30_90.txt" > "$TMP/manifest"
+for opts in "-s" "-c -t" "--classes -s"; do
+  "$SEARCHFVS" --threads 2 $opts --batch "$TMP/manifest" > "$TMP/status" || fail "$opts fails"
+  printf '%s\tok\n' "$TMP/ciona.txt	$TMP/ciona.result" "$TMP/random30_90.txt	$TMP/random30_90.txt.out" > "$TMP/expected"
+  cmp -s "$TMP/expected" "$TMP/status" || fail "$opts prints another status"
+  for result in "$TMP/ciona.txt:$TMP/ciona.result" "$TMP/random30_90.txt:$TMP/random30_90.txt.out"; do
+    f=${result%%:*}
+    "$SEARCHFVS" $opts "$f" > "$TMP/expected"
+    cmp -s "$TMP/expected" "${result#*:}" || fail "$opts differs for $(basename "$f")"
+  done
+done
+
+printf '%s\n' "$TMP/missing.txt" "$TMP/ciona.txt $TMP/ciona.result" > "$TMP/manifest"
+if "$SEARCHFVS" --batch "$TMP/manifest" > "$TMP/status" 2> "$TMP/err"; then
+  fail "succeeds with a missing network"
+fi
+grep -q "^$TMP/missing.txt	$TMP/missing.txt.out	error$" "$TMP/status" || fail "does not report the missing network"
+grep -q "^$TMP/ciona.txt	$TMP/ciona.result	ok$" "$TMP/status" || fail "fails for the other network"
+[ ! -e "$TMP/missing.txt.out" ] || fail "leaves the result of the missing network"
+echo "OK: --batch"
@@ -0,0 +1,47 @@
+#!/bin/sh
+# Check that the minimal FVSs of classes printed with --classes, expanded into the products of
+# the classes, are the same as the minimal FVSs printed without --classes (and with --stream),
+# for ciona.txt and the networks of tests/networks.awk.
+# Usage: tests/classes.sh <searchfvs binary>
+
+. "$(dirname "$0")/common.sh"
+
+# each minimal FVS as the sorted names of its nodes, where {A|B} is expanded into A and B
+fvss(){
+  awk 'function product(k,    alts, n, i, j, t, s){
+         if(k > num){
+           for(i = 1; i <= num; ++i)
+             sorted[i] = chosen[i]
+           for(i = 2; i <= num; ++i)
+             for(j = i; j > 1 && sorted[j - 1] > sorted[j]; --j){
+               t = sorted[j]; sorted[j] = sorted[j - 1]; sorted[j - 1] = t
+             }
+           s = sorted[1]
+           for(i = 2; i <= num; ++i)
+             s = s " " sorted[i]
+           print s
+           return
+         }
+         n = split(items[k], alts, "|")
+         for(i = 1; i <= n; ++i){
+           chosen[k] = alts[i]
+           product(k + 1)
+         }
+       }
+       /^ *[0-9]+: / { sub(/^ *[0-9]+: /, ""); gsub(/[{}]/, ""); num = split($0, items, ", "); product(1) }' | sort
+}
+
+networks
+for f in "$TMP"/*.txt; do
+  "$SEARCHFVS" "$f" > "$TMP/out"
+  fvss < "$TMP/out" > "$TMP/expected"
+  "$SEARCHFVS" --classes "$f" > "$TMP/out"
+  fvss < "$TMP/out" > "$TMP/actual"
+  "$SEARCHFVS" --stream "$f" > "$TMP/out"
+  fvss < "$TMP/out" > "$TMP/stream"
+  if ! cmp -s "$TMP/expected" "$TMP/actual" || ! cmp -s "$TMP/expected" "$TMP/stream"; then
+    echo "FAIL: the expanded FVSs of --classes differ for $(basename "$f")" >&2
+    exit 1
+  fi
+done
+echo "OK: --classes"
@@ -0,0 +1,35 @@
+# Setup sourced by the tests (. "$(dirname "$0")/common.sh"): SEARCHFVS is the binary given as
+# the first argument, DIR the directory of the tests and TMP a temporary directory removed at exit.
+
+set -e
+SEARCHFVS=$1
+DIR=$(dirname "$0")
+TMP=$(mktemp -d)
+trap 'rm -rf "$TMP"' EXIT
+
+# Write ciona.txt and the networks of tests/networks.awk to $TMP (as $TMP/*.txt).
+networks(){
+  cp "$DIR/../ciona.txt" "$TMP/ciona.txt"
+  awk -v dir="$TMP" -f "$DIR/networks.awk"
+}
+
+# Check that the option gives the same outputs as without it, for each of the other options
+# (one argument each) and each network of networks, except the line of the size of the kernel.
+#   same_outputs <option> <options>...
+same_outputs(){
+  option=$1
+  shift
+  networks
+  for f in "$TMP"/*.txt; do
+    for opts in "$@"; do
+      "$SEARCHFVS" $opts "$f" > "$TMP/expected"
+      "$SEARCHFVS" $opts $option "$f" > "$TMP/out"
+      grep -v 'of kernel' "$TMP/out" > "$TMP/actual" || true
+      if ! cmp -s "$TMP/expected" "$TMP/actual"; then
+        echo "FAIL: $option $opts differs for $(basename "$f")" >&2
+        exit 1
+      fi
+    done
+  done
+  echo "OK: $option"
+}
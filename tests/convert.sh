@@ -0,0 +1,23 @@
+#!/bin/sh
+# Check that the network converted by --convert to the binary format gives the same chordless
+# cycles, minimal FVSs and statistics as the text, also with --remove-node, for ciona.txt and the
+# networks of tests/networks.awk.
+# Usage: tests/convert.sh <searchfvs binary>
+
+. "$(dirname "$0")/common.sh"
+
+networks
+for f in "$TMP"/*.txt; do
+  "$SEARCHFVS" --convert "$TMP/network.bin" "$f" > /dev/null
+  # remove the nodes of the first edge
+  set -- $(grep -v '^#' "$f" | tr -d '\r' | head -1)
+  for opts in "" "-r $1" "-r $1 -r $2"; do
+    "$SEARCHFVS" -c -s $opts "$f" > "$TMP/expected"
+    "$SEARCHFVS" -c -s $opts "$TMP/network.bin" > "$TMP/actual"
+    if ! cmp -s "$TMP/expected" "$TMP/actual"; then
+      echo "FAIL: --convert $opts differs for $(basename "$f")" >&2
+      exit 1
+    fi
+  done
+done
+echo "OK: --convert"
@@ -0,0 +1,32 @@
+#!/bin/sh
+# Check that --count-only gives the same number of minimal FVSs and statistics as listing them
+# (also with --reduce) for ciona.txt and the networks of tests/networks.awk, and that the counts
+# beyond 64 bits are exact: 41 triangles x_i -> y_i -> z_i -> x_i chained by z_i -> x_{i+1}
+# have 3^41 minimal FVSs, 3^40 of which contain x_0.
+# Usage: tests/count_only.sh <searchfvs binary>
+
+. "$(dirname "$0")/common.sh"
+
+fail(){
+  echo "FAIL: --count-only $1" >&2
+  exit 1
+}
+
+networks
+for f in "$TMP"/*.txt; do
+  for opts in "" "--reduce"; do
+    "$SEARCHFVS" -s $opts "$f" | grep -v 'of kernel' > "$TMP/list"
+    "$SEARCHFVS" -s --count-only $opts "$f" | grep -v 'of kernel' > "$TMP/count"
+    grep -v '^ *[0-9]*: ' "$TMP/list" > "$TMP/expected"
+    grep -v '^#\[minimal FVSs\]' "$TMP/count" > "$TMP/actual"
+    cmp -s "$TMP/expected" "$TMP/actual" || fail "$opts: the statistics differ for $(basename "$f")"
+    [ "$(grep -c '^ *[0-9]*: ' "$TMP/list")" = "$(sed -n 's/^#\[minimal FVSs\] = //p' "$TMP/count")" ] ||
+      fail "$opts: the number differs for $(basename "$f")"
+  done
+done
+
+awk 'BEGIN { for(i = 0; i < 41; ++i) print "x" i " y" i "\ny" i " z" i "\nz" i " x" i "\nz" i " x" (i + 1) % 41 }' > "$TMP/triangles"
+"$SEARCHFVS" -s --count-only "$TMP/triangles" > "$TMP/count"
+grep -q '^#\[minimal FVSs\] = 36472996377170786403$' "$TMP/count" || fail "wraps the number of FVSs"
+grep -q '^ *x0: 12157665459056928801$' "$TMP/count" || fail "wraps the statistics"
+echo "OK: --count-only"
@@ -0,0 +1,41 @@
+#!/bin/sh
+# Check that --cycle-cache gives the same chordless cycles and minimal FVSs as without it, both
+# when the cache is written and when it is read, and that a cache of another network (or of the
+# network with removed nodes) or a truncated cache is rejected and written again.
+# Usage: tests/cycle_cache.sh <searchfvs binary>
+
+. "$(dirname "$0")/common.sh"
+
+fail(){
+  echo "FAIL: --cycle-cache $1" >&2
+  exit 1
+}
+
+networks
+for f in "$TMP"/*.txt; do
+  name=$(basename "$f")
+  "$SEARCHFVS" -c -s "$f" > "$TMP/expected"
+  "$SEARCHFVS" -c -s --cycle-cache "$f.cache" "$f" > "$TMP/actual"
+  cmp -s "$TMP/expected" "$TMP/actual" || fail "differs when written for $name"
+  "$SEARCHFVS" -c -s --cycle-cache "$f.cache" "$f" > "$TMP/actual"
+  cmp -s "$TMP/expected" "$TMP/actual" || fail "differs when read for $name"
+done
+
+# ciona.txt with the cache of another network, with the cache of ciona.txt without a node,
+# and with a truncated cache
+f=$TMP/ciona.txt
+"$SEARCHFVS" -c -s -r Foxd "$f" > "$TMP/expected.r"
+"$SEARCHFVS" -c -s -r Foxd --cycle-cache "$TMP/removed.cache" "$f" > /dev/null
+for cache in "$TMP/random30_90.txt.cache" "$TMP/removed.cache" truncated; do
+  if [ "$cache" = truncated ]; then
+    cache=$TMP/truncated.cache
+    head -c $(($(wc -c < "$f.cache") - 4)) "$f.cache" > "$cache"
+  fi
+  "$SEARCHFVS" -c -s --cycle-cache "$cache" "$f" > "$TMP/actual"
+  "$SEARCHFVS" -c -s "$f" > "$TMP/expected"
+  cmp -s "$TMP/expected" "$TMP/actual" || fail "differs with $(basename "$cache")"
+  cmp -s "$f.cache" "$cache" || fail "$(basename "$cache") is not written again"
+done
+"$SEARCHFVS" -c -s -r Foxd --cycle-cache "$f.cache" "$f" > "$TMP/actual"
+cmp -s "$TMP/expected.r" "$TMP/actual" || fail "differs for ciona.txt without a node"
+echo "OK: --cycle-cache"
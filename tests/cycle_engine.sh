@@ -0,0 +1,30 @@
+#!/bin/sh
+# Check that --cycle-engine induced detects the same chordless cycles as the search, with one
+# and several threads, for ciona.txt and networks generated by bench/gengraph (random, scale-free
+# and regulatory-style ones, sparse and dense).
+# Usage: tests/cycle_engine.sh <searchfvs binary>
+
+. "$(dirname "$0")/common.sh"
+
+cp "$DIR/../ciona.txt" "$TMP/ciona.txt"
+"$DIR/../bench/gengraph" random 60 3 1 > "$TMP/random.txt"
+"$DIR/../bench/gengraph" random 30 8 2 > "$TMP/random_dense.txt"
+"$DIR/../bench/gengraph" scalefree 150 3 3 > "$TMP/scalefree.txt"
+"$DIR/../bench/gengraph" grn 120 4 4 > "$TMP/grn.txt"
+"$DIR/../bench/gengraph" grn 80 10 5 > "$TMP/grn_dense.txt"
+for f in "$TMP"/*.txt; do
+  # (written to files first, so that a failure of searchfvs is not hidden by sort)
+  "$SEARCHFVS" -c -n --threads 1 "$f" > "$TMP/out"
+  sort "$TMP/out" > "$TMP/expected"
+  for threads in 1 3; do
+    for engine in search induced; do
+      "$SEARCHFVS" -c -n --threads $threads --cycle-engine $engine "$f" > "$TMP/out"
+      sort "$TMP/out" > "$TMP/actual"
+      if ! cmp -s "$TMP/expected" "$TMP/actual"; then
+        echo "FAIL: --cycle-engine $engine --threads $threads differs for $(basename "$f")" >&2
+        exit 1
+      fi
+    done
+  done
+done
+echo "OK: --cycle-engine"
@@ -0,0 +1,17 @@
+#!/bin/sh
+# Check that --enumerate-by-cbc gives the same minimal FVSs and statistics as the search by DFS
+# for ciona.txt and the networks of tests/networks.awk.
+# Usage: tests/enumerate_by_cbc.sh <searchfvs_withcbc binary>
+
+. "$(dirname "$0")/common.sh"
+
+networks
+for f in "$TMP"/*.txt; do
+  "$SEARCHFVS" -s "$f" > "$TMP/expected"
+  "$SEARCHFVS" -s --enumerate-by-cbc "$f" > "$TMP/actual"
+  if [ "$(sed 's/^ *[0-9]*: //' "$TMP/expected" | sort)" != "$(sed 's/^ *[0-9]*: //' "$TMP/actual" | sort)" ]; then
+    echo "FAIL: --enumerate-by-cbc differs for $(basename "$f")" >&2
+    exit 1
+  fi
+done
+echo "OK: --enumerate-by-cbc"
@@ -0,0 +1,100 @@
+#!/bin/sh
+# Check that the records of --format tsv, jsonl and binary (see writer.hh), converted back to
+# the names of nodes, give the same chordless cycles, minimal FVSs and statistics as the text,
+# for ciona.txt and the networks of tests/networks.awk.
+# Usage: tests/format.sh <searchfvs binary>
+
+. "$(dirname "$0")/common.sh"
+
+# the text as lines "cycle|header|fvs|stat <fields>" with the names of nodes
+fromtext(){
+  awk '/^#\[chordless cycles\]/ { sec = "cycle"; next }
+       /^#nodes/ { split($NF, n, ","); print "header", n[1], n[2], n[3]; sec = "fvs"; next }
+       /^Statistics:/ { sec = "stat"; next }
+       sec == "stat" && NF { c = $NF; sub(/: *[0-9]+$/, ""); sub(/^ */, ""); print "stat", $0, c; next }
+       /^ *[0-9]+: / { sub(/^ *[0-9]+: /, ""); print sec, $0 }'
+}
+
+# the same from tsv, where the indices of nodes are replaced with the names of node records
+fromtsv(){
+  awk -F '\t' '$1 == "node" { name[$2] = $3; next }
+               $1 == "header" { print "header", $2, $3, $4 }
+               $1 == "cycle" || $1 == "fvs" { s = name[$2]; for(i = 3; i <= NF; ++i) s = s ", " name[$i]; print $1, s }
+               $1 == "stat" { print "stat", name[$2], $3 }'
+}
+
+# jsonl to tsv (the fields of the records other than node are numbers in the order of tsv)
+jsonltotsv(){
+  awk '{ t = $0; sub(/^\{"type":"/, "", t); sub(/".*/, "", t) }
+       t == "node" { i = $0; sub(/.*"index":/, "", i); sub(/,.*/, "", i)
+                     n = $0; sub(/.*"name":"/, "", n); sub(/"\}$/, "", n); print "node\t" i "\t" n; next }
+       { s = $0; sub(/^\{"type":"[a-z]*"/, "", s); gsub(/[^0-9]+/, "\t", s); sub(/\t$/, "", s); print t s }'
+}
+
+# binary to tsv: the words are read as the bytes given by od, in the byte order of the first tag
+# (that of a node record, 1), and the number of records (that of the lines of tsv) is printed
+# to $TMP/numrecords
+binarytotsv(){
+  [ "$(head -c 8)" = SFVSOUT1 ] || { echo "FAIL: --format binary has no magic" >&2; exit 1; }
+  od -An -v -tu1 | awk -v numrecords="$TMP/numrecords" '
+    { for(i = 1; i <= NF; ++i) b[n++] = $i }
+    function word(    w, k){
+      w = 0
+      for(k = 0; k < 4; ++k)
+        w = w * 256 + b[p + (little ? 3 - k : k)]
+      p += 4
+      return w
+    }
+    function str(    len, s, k){
+      len = word()
+      for(k = 0; k < len; ++k)
+        s = s sprintf("%c", b[p + k])
+      p += int((len + 3) / 4) * 4
+      return s
+    }
+    function indices(m,    s, k){
+      for(k = 0; k < m; ++k)
+        s = s "\t" word()
+      return s
+    }
+    END {
+      little = b[0] == 1
+      while(p < n){
+        tag = word()
+        ++records
+        if(tag == 1){ i = word(); print "node\t" i "\t" str() }
+        else if(tag == 2) print "removed\t" str()
+        else if(tag == 3){ nodes = word(); edges = word(); size = word(); print "header\t" nodes "\t" edges "\t" size }
+        else if(tag == 4){ nodes = word(); print "kernel\t" nodes "\t" word() }
+        else if(tag == 5) print "cycle" indices(word())
+        else if(tag == 6) print "fvs" indices(size)
+        else if(tag == 7){ i = word(); print "stat\t" i "\t" str() }
+        else if(tag == 8) print "count\t" str()
+        else { print "unknown tag " tag > "/dev/stderr"; exit 1 }
+      }
+      print records > numrecords
+    }'
+}
+
+networks
+for f in "$TMP"/*.txt; do
+  name=$(basename "$f")
+  "$SEARCHFVS" -c -s "$f" > "$TMP/out"
+  fromtext < "$TMP/out" > "$TMP/expected"
+  for format in tsv jsonl binary; do
+    "$SEARCHFVS" -c -s --format $format "$f" > "$TMP/out"
+    case $format in
+      tsv) cp "$TMP/out" "$TMP/tsv"; wc -l < "$TMP/out" | tr -d ' ' > "$TMP/numlines" ;;
+      jsonl) jsonltotsv < "$TMP/out" > "$TMP/tsv" ;;
+      binary) binarytotsv < "$TMP/out" > "$TMP/tsv" ;;
+    esac
+    fromtsv < "$TMP/tsv" > "$TMP/actual"
+    if ! cmp -s "$TMP/expected" "$TMP/actual"; then
+      echo "FAIL: --format $format differs for $name" >&2
+      exit 1
+    fi
+  done
+  cmp -s "$TMP/numlines" "$TMP/numrecords" ||
+    { echo "FAIL: --format binary has another number of records for $name" >&2; exit 1; }
+done
+echo "OK: --format"
@@ -0,0 +1,15 @@
+#!/bin/sh
+# Check the minimal FVSs and statistics of ciona.txt against the expected output checked in
+# (tests/ciona_stat.expected, the same FVSs and numbers as the original implementation), so that
+# a change of the results shared by all the options is not missed by the other tests.
+# Usage: tests/golden.sh <searchfvs binary>
+
+. "$(dirname "$0")/common.sh"
+
+"$SEARCHFVS" -s "$DIR/../ciona.txt" > "$TMP/actual"
+if ! cmp -s "$DIR/ciona_stat.expected" "$TMP/actual"; then
+  diff "$DIR/ciona_stat.expected" "$TMP/actual" >&2 || true
+  echo "FAIL: the output for ciona.txt differs from tests/ciona_stat.expected" >&2
+  exit 1
+fi
+echo "OK: ciona.txt"
@@ -0,0 +1,39 @@
+#!/bin/sh
+# Check that each row of --knockout (the size and the number of minimal FVSs without the nodes)
+# is the same as the list of minimal FVSs with --remove-node for the nodes, for ciona.txt and
+# the networks of tests/networks.awk, and that the number beyond 64 bits is exact: 41 separate
+# triangles (SCCs) have 3^41 minimal FVSs, and 3^40 without a node of one of them.
+# Usage: tests/knockout.sh <searchfvs binary>
+
+. "$(dirname "$0")/common.sh"
+
+networks
+for f in "$TMP"/*.txt; do
+  # no nodes, the nodes of an edge and each of them, and the nodes of two edges
+  # (the lines of ciona.txt end with CR)
+  grep -v '^#' "$f" | tr -d '\r' | awk 'NR == 1 { print ""; print $1 " " $2; print $1; print $2 }
+                           NR == 2 { e = $1 " " $2 } NR == 3 { print e " " $1 " " $2 }' > "$TMP/knockout"
+  "$SEARCHFVS" --knockout "$TMP/knockout" "$f" | tail -n +2 > "$TMP/actual"
+  while read -r nodes; do
+    opts=
+    for v in $nodes; do
+      opts="$opts -r $v"
+    done
+    "$SEARCHFVS" $opts "$f" |
+      awk -v label="${nodes:--}" '/^#nodes/ { split($NF, n, ","); m = n[3] }
+                                  /^ *[0-9]+: / { ++count }
+                                  END { print label "\t" m "\t" count + 0 }'
+  done < "$TMP/knockout" > "$TMP/expected"
+  if ! cmp -s "$TMP/expected" "$TMP/actual"; then
+    echo "FAIL: --knockout differs for $(basename "$f")" >&2
+    exit 1
+  fi
+done
+awk 'BEGIN { for(i = 0; i < 41; ++i) print "x" i " y" i "\ny" i " z" i "\nz" i " x" i }' > "$TMP/triangles"
+printf '\nx0\n' > "$TMP/knockout"
+"$SEARCHFVS" --knockout "$TMP/knockout" "$TMP/triangles" > "$TMP/actual"
+if ! grep -q '^-	41	36472996377170786403$' "$TMP/actual" || ! grep -q '^x0	40	12157665459056928801$' "$TMP/actual"; then
+  echo "FAIL: --knockout wraps the number of FVSs" >&2
+  exit 1
+fi
+echo "OK: --knockout"
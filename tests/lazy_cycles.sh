@@ -0,0 +1,29 @@
+#!/bin/sh
+# Check that the FVS printed by --lazy-cycles is of the minimum size (the same as the search of
+# all the chordless cycles) and that the network has no cycle after removing its nodes, for
+# ciona.txt and the networks of tests/networks.awk.
+# Usage: tests/lazy_cycles.sh <searchfvs binary>
+
+. "$(dirname "$0")/common.sh"
+
+fail(){
+  echo "FAIL: --lazy-cycles $1" >&2
+  exit 1
+}
+
+networks
+for f in "$TMP"/*.txt; do
+  name=$(basename "$f")
+  "$SEARCHFVS" "$f" > "$TMP/expected"
+  "$SEARCHFVS" --lazy-cycles "$f" > "$TMP/actual"
+  [ "$(grep '^#nodes' "$TMP/expected")" = "$(grep '^#nodes' "$TMP/actual")" ] ||
+    fail "gives another size for $name"
+  opts=
+  for v in $(sed -n 's/^A minimal FVS: //p' "$TMP/actual" | tr -d ','); do
+    opts="$opts -r $v"
+  done
+  [ -n "$opts" ] || fail "prints no FVS for $name"
+  "$SEARCHFVS" -c -n $opts "$f" > "$TMP/cycles"
+  grep -q '^#\[chordless cycles\] = 0$' "$TMP/cycles" || fail "prints a non-FVS for $name"
+done
+echo "OK: --lazy-cycles"
@@ -0,0 +1,18 @@
+// The example of the library in README.md, built against libsearchfvs.a by make check:
+// print the minimal FVSs of ciona.txt (run in the top directory), one per line.
+#include <iostream>
+#include <vector>
+#include "searchfvs.hh"
+
+int main(){
+    digraph dg;
+    dg.read("ciona.txt", {});
+    dg.detectcycles();
+    dg.estimateminnumFVS();
+    dg.dfs();
+    dg.foreachminimalFVS([&](const std::vector<int>& FVS){
+        for(auto v: FVS)
+          std::cout << dg.nodename(v) << ' ';
+        std::cout << '\n';
+      });
+}
@@ -0,0 +1,28 @@
+#!/bin/sh
+# Check that the example of the library in README.md (tests/library.cc) prints the same
+# minimal FVSs of ciona.txt as searchfvs.
+# Usage: tests/library.sh <searchfvs binary> <binary of tests/library.cc>
+
+. "$(dirname "$0")/common.sh"
+LIBRARY=$(cd "$(dirname "$2")" && pwd)/$(basename "$2")
+
+# each FVS as the sorted names of its nodes, sorted
+sortFVSs(){
+  awk '{ n = split($0, v, " ")
+         for(i = 2; i <= n; ++i)
+           for(j = i; j > 1 && v[j - 1] > v[j]; --j){ t = v[j]; v[j] = v[j - 1]; v[j - 1] = t }
+         s = v[1]
+         for(i = 2; i <= n; ++i)
+           s = s " " v[i]
+         print s }' | sort
+}
+
+"$SEARCHFVS" "$DIR/../ciona.txt" > "$TMP/out"
+sed -n 's/^ *[0-9]*: //p' "$TMP/out" | tr -d ',' | sortFVSs > "$TMP/expected"
+(cd "$DIR/.." && "$LIBRARY") > "$TMP/out"
+sortFVSs < "$TMP/out" > "$TMP/actual"
+if [ ! -s "$TMP/expected" ] || ! cmp -s "$TMP/expected" "$TMP/actual"; then
+  echo "FAIL: the example of the library differs" >&2
+  exit 1
+fi
+echo "OK: library"
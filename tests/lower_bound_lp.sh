@@ -0,0 +1,25 @@
+#!/bin/sh
+# Check that the search pruned by --lower-bound lp (also with packing and with several threads)
+# gives the same minimal FVSs and statistics as --lower-bound none, for ciona.txt and
+# the networks of tests/networks.awk.
+# Usage: tests/lower_bound_lp.sh <searchfvs_withcbc binary>
+
+. "$(dirname "$0")/common.sh"
+
+# the output without the lines of --lower-bound (printed to stderr)
+results(){
+  "$SEARCHFVS" -s "$@" 2> "$TMP/bound"
+}
+
+networks
+for f in "$TMP"/*.txt; do
+  results --lower-bound none "$f" > "$TMP/expected"
+  for opts in "--lower-bound lp" "--lower-bound lp --lower-bound packing" "--lower-bound lp --threads 4"; do
+    results $opts "$f" > "$TMP/actual"
+    if ! cmp -s "$TMP/expected" "$TMP/actual"; then
+      echo "FAIL: $opts differs for $(basename "$f")" >&2
+      exit 1
+    fi
+  done
+done
+echo "OK: --lower-bound lp"
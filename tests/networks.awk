@@ -0,0 +1,32 @@
+# Write the networks for the tests to the directory dir: random networks of n nodes and m edges
+# (no self-loops nor duplicates) named random<n>_<m>.txt, sparse and dense ones, and selfloops.txt:
+# the random network of 30 nodes and 90 edges with self-loops on a few nodes (inside an SCC) and
+# an isolated 2-cycle, whose nodes are forced into FVSs (and expanded back) by --reduce.
+#   awk -v dir=<directory> -f tests/networks.awk
+function network(n, m, seed,    file, count, u, v, edges){
+  srand(seed)
+  file = dir "/random" n "_" m ".txt"
+  while(count < m){
+    u = int(rand() * n)
+    v = int(rand() * n)
+    if(u != v && !((u, v) in edges)){
+      edges[u, v] = 1
+      print "N" u " N" v > file
+      ++count
+    }
+  }
+  close(file)
+}
+
+BEGIN {
+  network(30, 90, 1)
+  network(60, 150, 3)
+  network(40, 160, 2)
+  network(25, 150, 4)
+  file = dir "/selfloops.txt"
+  while((getline line < (dir "/random30_90.txt")) > 0)
+    print line > file
+  close(dir "/random30_90.txt")
+  print "N3 N3\nN17 N17\nN22 N22\nA B\nB A" > file
+  close(file)
+}
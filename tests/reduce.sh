@@ -0,0 +1,9 @@
+#!/bin/sh
+# Check that --reduce gives the same minimal FVSs, statistics, polynomial and tree as without it
+# (except the line of the size of the kernel) for ciona.txt and the networks of tests/networks.awk,
+# including selfloops.txt, whose nodes with self-loops are forced into the FVSs.
+# Usage: tests/reduce.sh <searchfvs binary>
+
+. "$(dirname "$0")/common.sh"
+
+same_outputs --reduce "-s" "-p" "-t" "-t -p"
@@ -0,0 +1,8 @@
+#!/bin/sh
+# Check that --split gives the same minimal FVSs, statistics, polynomial and tree as the search
+# without it for ciona.txt and the networks of tests/networks.awk.
+# Usage: tests/split.sh <searchfvs binary>
+
+. "$(dirname "$0")/common.sh"
+
+same_outputs --split "-s" "-p" "-t"
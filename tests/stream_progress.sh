@@ -0,0 +1,23 @@
+#!/bin/sh
+# Run --stream together with --progress, whose lines are printed by another thread while
+# the minimal FVSs are written to the buffered stdout, and check that the FVSs are the same
+# as without --progress and that progress lines are printed.
+# Usage: tests/stream_progress.sh <searchfvs binary>
+# (make check-tsan runs this for a binary built with ThreadSanitizer, which fails on a race.)
+
+. "$(dirname "$0")/common.sh"
+
+"$DIR/../bench/gengraph" scalefree 200 3 1 > "$TMP/network.txt"
+"$SEARCHFVS" --stream --threads 2 "$TMP/network.txt" > "$TMP/expected"
+"$SEARCHFVS" --stream --progress 0.05 --threads 2 "$TMP/network.txt" > "$TMP/actual" 2> "$TMP/progress"
+# the FVSs are numbered in the order found, which depends on the threads
+if ! cmp -s "$TMP/expected" "$TMP/actual" &&
+   [ "$(sed 's/^ *[0-9]*: //' "$TMP/expected" | sort)" != "$(sed 's/^ *[0-9]*: //' "$TMP/actual" | sort)" ]; then
+  echo "FAIL: the minimal FVSs differ with --progress" >&2
+  exit 1
+fi
+if ! grep -q '^\[progress\]' "$TMP/progress"; then
+  echo "FAIL: no progress lines" >&2
+  exit 1
+fi
+echo "OK: --stream with --progress"
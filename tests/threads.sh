@@ -0,0 +1,22 @@
+#!/bin/sh
+# Check that the parallel branch and bound with --threads 4 gives the same minimal FVSs and
+# statistics as --threads 1, also with --split and --classes, for ciona.txt, the networks of
+# tests/networks.awk and larger networks generated by bench/gengraph.
+# Usage: tests/threads.sh <searchfvs binary>
+
+. "$(dirname "$0")/common.sh"
+
+networks
+"$DIR/../bench/gengraph" scalefree 200 3 1 > "$TMP/scalefree.txt"
+"$DIR/../bench/gengraph" grn 120 4 4 > "$TMP/grn.txt"
+for f in "$TMP"/*.txt; do
+  for opts in "" "--split" "--classes"; do
+    "$SEARCHFVS" -s --threads 1 $opts "$f" > "$TMP/expected"
+    "$SEARCHFVS" -s --threads 4 $opts "$f" > "$TMP/actual"
+    if ! cmp -s "$TMP/expected" "$TMP/actual"; then
+      echo "FAIL: --threads 4 $opts differs for $(basename "$f")" >&2
+      exit 1
+    fi
+  done
+done
+echo "OK: --threads"
@@ -0,0 +1,127 @@
+// threadpool.hh, written by Kazuki Maeda <kmaeda at kmaeda.net>, 2020
+
+#ifndef _THREADPOOL_HH_
+#define _THREADPOOL_HH_
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// A pool of threads with work stealing.
+// Each worker has its own deque of tasks: it takes tasks from the back of its deque,
+// and steals tasks from the front of the others' when its deque is empty.
+// A task is called with the index of the worker running it, so that
+// tasks can use per-worker buffers and submit subtasks to their own deques.
+class threadpool {
+public:
+  typedef std::function<void(const int)> task;
+
+private:
+  struct worker {
+    std::mutex m;
+    std::deque<task> tasks;
+  };
+
+  std::vector<std::thread> threads;
+  std::vector<std::unique_ptr<worker>> workers;
+  std::mutex m;
+  std::condition_variable cv, donecv;
+  std::atomic<long> numqueued, numpending; // pending = queued + running
+  std::atomic<unsigned int> next;
+  bool stop;
+
+  threadpool(const threadpool&) = delete;
+  threadpool& operator=(const threadpool&) = delete;
+
+  bool take(const int id, task& t){
+    {
+      std::lock_guard<std::mutex> lk(workers[id]->m);
+      if(!workers[id]->tasks.empty()){
+        t = std::move(workers[id]->tasks.back());
+        workers[id]->tasks.pop_back();
+        return true;
+      }
+    }
+    for(unsigned int k = 1; k < workers.size(); ++k){
+      auto& w = *workers[(id + k) % workers.size()];
+      std::lock_guard<std::mutex> lk(w.m);
+      if(!w.tasks.empty()){
+        t = std::move(w.tasks.front());
+        w.tasks.pop_front();
+        return true;
+      }
+    }
+    return false;
+  }
+
+  void run(const int id){
+    while(true){
+      task t;
+      if(take(id, t)){
+        --numqueued;
+        t(id);
+        if(--numpending == 0){
+          std::lock_guard<std::mutex> lk(m);
+          donecv.notify_all();
+        }
+        continue;
+      }
+      std::unique_lock<std::mutex> lk(m);
+      cv.wait(lk, [&]{ return stop || numqueued > 0; });
+      if(stop && numqueued == 0)
+        return;
+    }
+  }
+
+public:
+  explicit threadpool(const int numthreads)
+    : numqueued(0), numpending(0), next(0), stop(false) {
+    for(auto i = 0; i < numthreads; ++i)
+      workers.emplace_back(new worker);
+    for(auto i = 0; i < numthreads; ++i)
+      threads.emplace_back(&threadpool::run, this, i);
+  }
+
+  ~threadpool(){
+    {
+      std::lock_guard<std::mutex> lk(m);
+      stop = true;
+    }
+    cv.notify_all();
+    for(auto& t: threads)
+      t.join();
+  }
+
+  inline int size() const {
+    return workers.size();
+  }
+
+  // Submit a task to the deque of worker id (to the next one in turn if id < 0).
+  void submit(task t, int id = -1){
+    if(id < 0)
+      id = next++ % workers.size();
+    ++numpending;
+    {
+      std::lock_guard<std::mutex> lk(workers[id]->m);
+      workers[id]->tasks.push_back(std::move(t));
+    }
+    {
+      std::lock_guard<std::mutex> lk(m);
+      ++numqueued;
+    }
+    cv.notify_one();
+  }
+
+  // Wait until all the tasks (including those submitted by tasks) have been done.
+  void wait(){
+    std::unique_lock<std::mutex> lk(m);
+    donecv.wait(lk, [&]{ return numpending == 0; });
+  }
+};
+
+#endif
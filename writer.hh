@@ -0,0 +1,277 @@
+// writer.hh, written by Kazuki Maeda <kmaeda at kmaeda.net>, 2020
+
+#ifndef _WRITER_HH_
+#define _WRITER_HH_
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <ostream>
+#include <streambuf>
+#include <string>
+#include <utility>
+#include <vector>
+
+// Buffer of an ostream (e.g., std::cout) while it lives, which passes the output to
+// the original buffer in large blocks: it is flushed only when full, by flush
+// (std::endl), and when destroyed.
+class outbuffer : public std::streambuf {
+  std::ostream& os;
+  std::streambuf* original;
+  std::vector<char> buf;
+
+  outbuffer(const outbuffer&) = delete;
+  outbuffer& operator=(const outbuffer&) = delete;
+
+  bool drain(){
+    auto n = pptr() - pbase();
+    if(n && original->sputn(pbase(), n) != n)
+      return false;
+    setp(buf.data(), buf.data() + buf.size());
+    return true;
+  }
+
+protected:
+  int_type overflow(int_type c){
+    if(!drain())
+      return traits_type::eof();
+    if(!traits_type::eq_int_type(c, traits_type::eof())){
+      *pptr() = traits_type::to_char_type(c);
+      pbump(1);
+    }
+    return traits_type::not_eof(c);
+  }
+
+  std::streamsize xsputn(const char* s, std::streamsize n){
+    if(n > epptr() - pptr()){
+      if(!drain())
+        return 0;
+      if(n > epptr() - pptr())  // larger than the buffer
+        return original->sputn(s, n);
+    }
+    std::copy(s, s + n, pptr());
+    pbump(n);
+    return n;
+  }
+
+  int sync(){
+    return drain() ? original->pubsync() : -1;
+  }
+
+public:
+  explicit outbuffer(std::ostream& os, const size_t size = 1 << 20)
+    : os(os), original(os.rdbuf()), buf(size) {
+    setp(buf.data(), buf.data() + buf.size());
+    os.rdbuf(this);
+  }
+
+  ~outbuffer(){
+    sync();
+    os.rdbuf(original);
+  }
+};
+
+enum class outputformat { text, tsv, jsonl, binary };
+
+// Records of the results in a machine-readable format, where nodes are given by their indices
+// (listed in node records):
+//  tsv:    a line per record; the type followed by the fields separated by tabs,
+//          e.g., "fvs\t3\t7" (the indices of the nodes of a minimal FVS).
+//  jsonl:  a JSON object per line, e.g., {"type":"fvs","nodes":[3,7]}.
+//  binary: "SFVSOUT1", then the records in the native byte order, each of which is a tag (uint32)
+//          followed by uint32 fields; a string is its length followed by the bytes padded with
+//          zeros to a multiple of 4 bytes, and numbers of FVSs are decimal strings.
+// Records (tag: fields):
+//  node    (1): index, name
+//  removed (2): name of a node removed by --remove-node
+//  header  (3): the numbers of nodes, edges and nodes of minimal FVSs
+//  kernel  (4): the numbers of nodes and edges of the kernel (if reduced)
+//  cycle   (5): the number of nodes (only in binary), indices
+//  fvs     (6): indices (in binary, as many as the nodes of minimal FVSs given by header)
+//  stat    (7): index, the number of minimal FVSs containing the node
+//  count   (8): the number of minimal FVSs
+class recordwriter {
+  std::ostream& os;
+  const outputformat format;
+
+  inline void put(const uint32_t x){
+    os.write(reinterpret_cast<const char*>(&x), sizeof(x));
+  }
+
+  void putstring(const std::string& s){
+    put(s.length());
+    os.write(s.data(), s.length());
+    for(auto k = s.length(); k % 4; ++k)
+      os.put('\0');
+  }
+
+  void jsonstring(const std::string& s){
+    os << '"';
+    for(const auto& c: s)
+      if(c == '"' || c == '\\')
+        os << '\\' << c;
+      else if((unsigned char)c < 0x20){
+        char u[8];
+        snprintf(u, sizeof(u), "\\u%04x", (unsigned int)c);
+        os << u;
+      } else
+        os << c;
+    os << '"';
+  }
+
+  // Record of the numbers.
+  void numbers(const char* type, const uint32_t tag,
+               const std::vector<std::pair<const char*, unsigned long long>>& fields){
+    switch(format){
+    case outputformat::tsv:
+      os << type;
+      for(const auto& f: fields)
+        os << '\t' << f.second;
+      os << '\n';
+      break;
+    case outputformat::jsonl:
+      os << "{\"type\":\"" << type << '"';
+      for(const auto& f: fields)
+        os << ",\"" << f.first << "\":" << f.second;
+      os << "}\n";
+      break;
+    case outputformat::binary:
+      put(tag);
+      for(const auto& f: fields)
+        put(f.second);
+      break;
+    case outputformat::text:
+      break;
+    }
+  }
+
+  // Record of a list of nodes.
+  template<class I>
+  void list(const char* type, const uint32_t tag, I begin, const I end, const bool withlength){
+    switch(format){
+    case outputformat::tsv:
+      os << type;
+      for(; begin != end; ++begin)
+        os << '\t' << *begin;
+      os << '\n';
+      break;
+    case outputformat::jsonl:
+      os << "{\"type\":\"" << type << "\",\"nodes\":[";
+      for(auto i = begin; i != end; ++i)
+        os << (i == begin ? "" : ",") << *i;
+      os << "]}\n";
+      break;
+    case outputformat::binary:
+      put(tag);
+      if(withlength)
+        put(end - begin);
+      for(; begin != end; ++begin)
+        put(*begin);
+      break;
+    case outputformat::text:
+      break;
+    }
+  }
+
+public:
+  recordwriter(std::ostream& os, const outputformat format) : os(os), format(format) {}
+
+  // The beginning of the output.
+  void begin(){
+    if(format == outputformat::binary)
+      os.write("SFVSOUT1", 8);
+  }
+
+  void node(const int index, const std::string& name){
+    switch(format){
+    case outputformat::tsv:
+      os << "node\t" << index << '\t' << name << '\n';
+      break;
+    case outputformat::jsonl:
+      os << "{\"type\":\"node\",\"index\":" << index << ",\"name\":";
+      jsonstring(name);
+      os << "}\n";
+      break;
+    case outputformat::binary:
+      put(1);
+      put(index);
+      putstring(name);
+      break;
+    case outputformat::text:
+      break;
+    }
+  }
+
+  void removed(const std::string& name){
+    switch(format){
+    case outputformat::tsv:
+      os << "removed\t" << name << '\n';
+      break;
+    case outputformat::jsonl:
+      os << "{\"type\":\"removed\",\"name\":";
+      jsonstring(name);
+      os << "}\n";
+      break;
+    case outputformat::binary:
+      put(2);
+      putstring(name);
+      break;
+    case outputformat::text:
+      break;
+    }
+  }
+
+  void header(const int numnodes, const int numedges, const unsigned int minnumFVS){
+    numbers("header", 3, {{"nodes", numnodes}, {"edges", numedges}, {"minnumFVS", minnumFVS}});
+  }
+
+  void kernel(const int numnodes, const int numedges){
+    numbers("kernel", 4, {{"nodes", numnodes}, {"edges", numedges}});
+  }
+
+  void cycle(const std::vector<int>& nodes){
+    list("cycle", 5, nodes.cbegin(), nodes.cend(), true);
+  }
+
+  void FVS(const int* nodes, const unsigned int n){
+    list("fvs", 6, nodes, nodes + n, false);
+  }
+
+  // count is a decimal number.
+  void stat(const int node, const std::string& count){
+    switch(format){
+    case outputformat::tsv:
+      os << "stat\t" << node << '\t' << count << '\n';
+      break;
+    case outputformat::jsonl:
+      os << "{\"type\":\"stat\",\"node\":" << node << ",\"count\":" << count << "}\n";
+      break;
+    case outputformat::binary:
+      put(7);
+      put(node);
+      putstring(count);
+      break;
+    case outputformat::text:
+      break;
+    }
+  }
+
+  void count(const std::string& numFVSs){
+    switch(format){
+    case outputformat::tsv:
+      os << "count\t" << numFVSs << '\n';
+      break;
+    case outputformat::jsonl:
+      os << "{\"type\":\"count\",\"FVSs\":" << numFVSs << "}\n";
+      break;
+    case outputformat::binary:
+      put(8);
+      putstring(numFVSs);
+      break;
+    case outputformat::text:
+      break;
+    }
+  }
+};
+
+#endif